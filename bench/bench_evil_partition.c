@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "bench_words.h"
+#include "../game/hangman.h"
+#include "../game/solver.h"
+#include "../utility/utilities.h"
+
+//measures the latency of one evil hangman guess, which partitions every remaining candidate
+//usage: bench_evil_partition [words] [games] [word length]
+
+static void printPercentiles(const char *label, double *samples, long count) {
+    if (count == 0) return;
+    qsort(samples, count, sizeof(double), compareDoubles);
+    printf("%-12s %8ld %10.3f %10.3f %10.3f %10.3f\n", label, count, samples[count / 2] * 1e6,
+           samples[count * 90 / 100] * 1e6, samples[count * 99 / 100] * 1e6, samples[count - 1] * 1e6);
+}
+
+int main(int argc, char *argv[]) {
+    long wordCount = argc > 1 ? atol(argv[1]) : 100000;
+    int games = argc > 2 ? atoi(argv[2]) : 200;
+    int length = argc > 3 ? atoi(argv[3]) : 8;
+    const char *path = "bench_evil_partition.txt";
+    if (length < 1 || length >= MAX_WORD_LEN) length = 8;
+
+    Prng rng;
+    prngSeed(&rng, 1234);
+
+    //synthetic words of one length, the skewed letters make families uneven
+    Dictionary dict;
+    if (!benchBuildWords(&dict, path, wordCount, length, length, &rng)) return 1;
+
+    long capacity = (long) games * ALPHABET_SIZE;
+    double *all = malloc(capacity * sizeof(double));
+    double *first = malloc(games * sizeof(double));
+    if (!all || !first) return 1;
+    long sampleCount = 0;
+    long wins = 0;
+
+    //guesses follow letter frequency, the strongest order a player without the word list can use
+    double start = nowSeconds();
+    for (int g = 0; g < games; g++) {
+        const char *word = dictionaryWordString(&dict, prngBounded(&rng, dict.header->wordCount));
+        EvilHangman evil;
+        GameState game = initEvilHangman(&evil, &dict, 0, word, 6, prngNext(&rng));
+
+        for (int i = 0; g_letterFrequencyOrder[i] != '\0' && !isGameOver(&game); i++) {
+            double t = nowSeconds();
+            processGuess(&game, g_letterFrequencyOrder[i]);
+            double elapsed = nowSeconds() - t;
+
+            appendCharToArray(game.guessed, g_letterFrequencyOrder[i], &game.numGuessed, MAX_GUESSED);
+            if (i == 0) first[g] = elapsed;
+            all[sampleCount++] = elapsed;
+        }
+        if (isGameWon(&game)) wins++;
+
+        evilHangmanDestroy(&evil);
+    }
+    double total = nowSeconds() - start;
+
+    printf("words: %u, length: %d, games: %d, player wins: %ld, time: %.2f s\n\n", dict.header->wordCount, length,
+           games, wins, total);
+    printf("%-12s %8s %10s %10s %10s %10s\n", "guess (us)", "samples", "p50", "p90", "p99", "max");
+    printPercentiles("first", first, games);
+    printPercentiles("all", all, sampleCount);
+
+    free(all);
+    free(first);
+    dictionaryClose(&dict);
+    return 0;
+}
@@ -0,0 +1,93 @@
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "../screens/graphics/texture_paths.h"
+#include "../utility/job_pool.h"
+
+//decodes the game images through the job pool at 1, 2, 4, 8 and 16 threads, one job per image like the loading screen
+//usage: bench_parallel_decode [rounds] [image.png...]   run from the repository root to use the game images
+
+typedef struct {
+    const char *path;
+    SDL_Surface *surface;
+} DecodeItem;
+
+static atomic_int g_failures;
+
+static void decodeItem(void *data) {
+    DecodeItem *item = data;
+    item->surface = IMG_Load(item->path);
+    if (!item->surface) atomic_fetch_add(&g_failures, 1);
+}
+
+static void freeItems(DecodeItem *items, int count) {
+    for (int i = 0; i < count; i++) {
+        if (items[i].surface) SDL_FreeSurface(items[i].surface);
+        items[i].surface = NULL;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 5;
+    if (rounds < 1) rounds = 1;
+
+    //by default every image textureManagerStartAsyncLoad() decodes
+    const char *paths[256];
+    int count = 0;
+    if (argc > 2) {
+        for (int i = 2; i < argc && count < 256; i++) paths[count++] = argv[i];
+    } else {
+        for (int i = 0; i < TEXTURE_PATH_COUNT; i++) paths[count++] = g_texturePaths[i];
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        printf("[ERROR] SDL_image init failed: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    DecodeItem *items = calloc(count, sizeof(DecodeItem));
+    if (!items) return 1;
+    for (int i = 0; i < count; i++) items[i].path = paths[i];
+
+    //warm the page cache so the numbers measure decoding, not the disk
+    for (int i = 0; i < count; i++) decodeItem(&items[i]);
+    freeItems(items, count);
+    if (atomic_load(&g_failures) > 0) {
+        printf("[ERROR] %d of %d images failed to load, run from the repository root\n", atomic_load(&g_failures),
+               count);
+        free(items);
+        return 1;
+    }
+
+    printf("images: %d, rounds: %d, logical processors: %d\n", count, rounds, threadCpuCount());
+    double baseline = 0.0;
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        JobPool pool;
+        if (!jobPoolCreate(&pool, threads)) {
+            printf("[ERROR] Failed to start %d threads\n", threads);
+            break;
+        }
+
+        double elapsed = 0.0;
+        for (int r = 0; r < rounds; r++) {
+            double start = nowSeconds();
+            for (int i = 0; i < count; i++) jobPoolSubmit(&pool, decodeItem, &items[i]);
+            jobPoolWait(&pool);
+            elapsed += nowSeconds() - start;
+            freeItems(items, count);
+        }
+        elapsed /= rounds;
+        jobPoolDestroy(&pool);
+
+        if (threads == 1) baseline = elapsed;
+        printf("threads: %2d  load: %7.1f ms  speedup: %.2fx\n", threads, elapsed * 1000.0, baseline / elapsed);
+    }
+
+    free(items);
+    IMG_Quit();
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "../game/session_pool.h"
+#include "../utility/word_corpus.h"
+
+//creates and destroys millions of compact sessions to measure pool throughput and footprint
+//usage: bench_session_pool [sessions]
+
+int main(int argc, char *argv[]) {
+    long count = argc > 1 ? atol(argv[1]) : 10000000;
+
+    if (!wordCorpusInit()) {
+        printf("[ERROR] Failed to load words\n");
+        return 1;
+    }
+    const Dictionary *dict = wordCorpusDictionary();
+    uint32_t wordCount = dict->header->wordCount;
+
+    SessionPool pool;
+    if (!sessionPoolInit(&pool, dict)) return 1;
+
+    SessionHandle *handles = malloc(count * sizeof(SessionHandle));
+    if (!handles) {
+        printf("[ERROR] Out of memory\n");
+        return 1;
+    }
+
+    Prng rng;
+    prngSeed(&rng, 42);
+
+    //every session is live at the same time after this loop
+    double start = nowSeconds();
+    for (long i = 0; i < count; i++) {
+        handles[i] = sessionCreate(&pool, prngBounded(&rng, wordCount), 6, (uint64_t) i);
+    }
+    double createTime = nowSeconds() - start;
+    size_t memory = sessionPoolMemoryUsage(&pool);
+
+    //one guess per session through its handle, in random order
+    start = nowSeconds();
+    long hits = 0;
+    for (long i = 0; i < count; i++) {
+        HangmanSession *session = sessionGet(&pool, handles[prngBounded(&rng, (uint32_t) count)]);
+        if (session && sessionValidateGuess(session, 'e')) {
+            sessionProcessGuess(&pool, session, 'e');
+            hits++;
+        }
+    }
+    double guessTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (long i = 0; i < count; i++) {
+        sessionDestroy(&pool, handles[i]);
+    }
+    double destroyTime = nowSeconds() - start;
+
+    //second round reuses the free list, no slabs are allocated
+    start = nowSeconds();
+    for (long i = 0; i < count; i++) {
+        handles[i] = sessionCreate(&pool, prngBounded(&rng, wordCount), 6, (uint64_t) i);
+    }
+    for (long i = 0; i < count; i++) {
+        sessionDestroy(&pool, handles[i]);
+    }
+    double reuseTime = nowSeconds() - start;
+
+    printf("sessions: %ld, sizeof(HangmanSession): %zu bytes\n", count, sizeof(HangmanSession));
+    printf("pool memory: %.1f MB (%.1f bytes per session)\n", memory / (1024.0 * 1024.0), (double) memory / count);
+    printf("create:          %7.1f ns/session (%.1f M/s)\n", createTime * 1e9 / count, count / createTime / 1e6);
+    printf("guess:           %7.1f ns/session (%ld guesses)\n", guessTime * 1e9 / count, hits);
+    printf("destroy:         %7.1f ns/session (%.1f M/s)\n", destroyTime * 1e9 / count, count / destroyTime / 1e6);
+    printf("create+destroy:  %7.1f ns/session on reused slots\n", reuseTime * 1e9 / count);
+
+    free(handles);
+    sessionPoolDestroy(&pool);
+    wordCorpusDestroy();
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "bench_words.h"
+#include "../game/hangman.h"
+#include "../game/solver.h"
+#include "../utility/utilities.h"
+
+//enforces the smart hint budget: fails when any query on one large category takes 1 ms or longer
+//usage: bench_smart_hint [words] [games]
+//every query of a game is timed, from the fresh word to the last guess
+//two categories are measured, one spread over lengths 4 to 12 and one with every word the same length,
+//the hint only looks at the words of the secret's length so the second is the worst case
+//each query runs a few times and the fastest run counts, so a time slice lost to another process is not a slow query
+
+#define HINT_BUDGET_SECONDS 0.001
+#define HINT_RUNS 3
+
+/**
+ * Plays games on one synthetic category following every hint, and reports the query times
+ *
+ * @param label name printed with the results
+ * @param wordCount number of words in the category
+ * @param minLength shortest word length
+ * @param maxLength longest word length
+ * @param games number of games to play
+ * @param rng generator for the words and the secrets
+ * @return true if every query was under the budget
+ */
+static bool benchCategory(const char *label, long wordCount, int minLength, int maxLength, int games, Prng *rng) {
+    Dictionary dict;
+    if (!benchBuildWords(&dict, "bench_smart_hint.txt", wordCount, minLength, maxLength, rng)) return false;
+
+    double buildStart = nowSeconds();
+    SolverIndex index;
+    if (!solverIndexBuild(&index, &dict)) {
+        printf("[ERROR] Failed to build solver index\n");
+        dictionaryClose(&dict);
+        return false;
+    }
+    double buildTime = nowSeconds() - buildStart;
+
+    double *samples = malloc((size_t) games * ALPHABET_SIZE * sizeof(double));
+    if (!samples) {
+        solverIndexDestroy(&index);
+        dictionaryClose(&dict);
+        return false;
+    }
+    long sampleCount = 0;
+
+    //the player follows every hint, so each game walks from a full group down to one candidate
+    for (int g = 0; g < games; g++) {
+        uint32_t wordIndex = prngBounded(rng, dict.header->wordCount);
+        GameState game = initHangman("synthetic", dictionaryWordString(&dict, wordIndex), 6, prngNext(rng));
+
+        while (!isGameWon(&game) && game.numGuessed < ALPHABET_SIZE) {
+            char hint = 0;
+            double fastest = 0;
+            for (int r = 0; r < HINT_RUNS; r++) {
+                double t = nowSeconds();
+                hint = solverIndexSmartHint(&index, &game, 0);
+                t = nowSeconds() - t;
+                if (r == 0 || t < fastest) fastest = t;
+            }
+            samples[sampleCount++] = fastest;
+
+            if (!validateGuess(&game, hint)) break;
+            processGuess(&game, hint);
+            appendCharToArray(game.guessed, hint, &game.numGuessed, MAX_GUESSED);
+        }
+    }
+
+    qsort(samples, sampleCount, sizeof(double), compareDoubles);
+    double p50 = samples[sampleCount / 2];
+    double p99 = samples[sampleCount * 99 / 100];
+    double max = samples[sampleCount - 1];
+
+    int largestGroup = 0;
+    for (int g = 0; g < index.categories[0].groupCount; g++) {
+        if ((int) index.categories[0].groups[g].count > largestGroup) largestGroup = index.categories[0].groups[g].count;
+    }
+
+    printf("%s: words: %u, largest length group: %d, index build: %.1f ms\n", label, dict.header->wordCount,
+           largestGroup, buildTime * 1000.0);
+    printf("%s: queries: %ld, p50: %.1f us, p99: %.1f us, max: %.1f us\n", label, sampleCount, p50 * 1e6,
+           p99 * 1e6, max * 1e6);
+
+    bool withinBudget = max < HINT_BUDGET_SECONDS;
+    printf("%s: %s: slowest query %s the %.1f ms budget\n", label, withinBudget ? "PASS" : "FAIL",
+           withinBudget ? "is within" : "exceeds", HINT_BUDGET_SECONDS * 1000.0);
+
+    free(samples);
+    solverIndexDestroy(&index);
+    dictionaryClose(&dict);
+    return withinBudget;
+}
+
+int main(int argc, char *argv[]) {
+    long wordCount = argc > 1 ? atol(argv[1]) : 200000;
+    int games = argc > 2 ? atoi(argv[2]) : 500;
+
+    Prng rng;
+    prngSeed(&rng, 1234);
+
+    bool spread = benchCategory("lengths 4-12", wordCount, 4, 12, games, &rng);
+    bool single = benchCategory("length 8", wordCount, 8, 8, games, &rng);
+    return spread && single ? 0 : 1;
+}
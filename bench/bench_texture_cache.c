@@ -0,0 +1,114 @@
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "../screens/graphics/texture_cache.h"
+#include "../screens/graphics/texture_paths.h"
+
+//compares getting the game images ready for upload on a cold start, PNG decode plus conversion to the renderer format,
+//with a warm start that maps the same pixels from the texture cache
+//usage: bench_texture_cache [rounds] [image.png...]   run from the repository root to use the game images
+
+//reads every row like the upload would, so the warm numbers include faulting the pages in
+static Uint32 touchPixels(const SDL_Surface *surface) {
+    Uint32 sum = 0;
+    for (int y = 0; y < surface->h; y++) {
+        const Uint32 *row = (const Uint32 *) ((const Uint8 *) surface->pixels + (size_t) y * surface->pitch);
+        for (int x = 0; x < surface->w; x += 16) sum += row[x];
+    }
+    return sum;
+}
+
+static SDL_Surface *decodeImage(const char *path, Uint32 format) {
+    SDL_Surface *loaded = IMG_Load(path);
+    if (!loaded) return NULL;
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, format, 0);
+    SDL_FreeSurface(loaded);
+    return converted;
+}
+
+int main(int argc, char *argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 5;
+    if (rounds < 1) rounds = 1;
+
+    //by default every image textureManagerStartAsyncLoad() decodes
+    const char *paths[256];
+    int count = 0;
+    if (argc > 2) {
+        for (int i = 2; i < argc && count < 256; i++) paths[count++] = argv[i];
+    } else {
+        for (int i = 0; i < TEXTURE_PATH_COUNT; i++) paths[count++] = g_texturePaths[i];
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        printf("[ERROR] SDL_image init failed: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    //a directory of its own, so the game's cache is left alone
+    char *dir = SDL_GetPrefPath(TEXTURE_CACHE_APP_NAME, "bench_texture_cache");
+    if (!dir || !textureCacheInit(dir)) {
+        printf("[ERROR] No directory for the cache: %s\n", SDL_GetError());
+        return 1;
+    }
+    printf("cache: %s\n", dir);
+    SDL_free(dir);
+
+    const Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+    Uint32 checksum = 0;
+    size_t bytes = 0;
+
+    //fill the cache, and warm the page cache for the PNGs so both sides read from memory
+    for (int i = 0; i < count; i++) {
+        SDL_Surface *surface = decodeImage(paths[i], format);
+        if (!surface) {
+            printf("[ERROR] Failed to load %s, run from the repository root\n", paths[i]);
+            return 1;
+        }
+        if (!textureCacheStore(paths[i], TEXTURE_TIER_FULL, surface, NULL)) {
+            printf("[ERROR] Failed to cache %s\n", paths[i]);
+            return 1;
+        }
+        bytes += (size_t) surface->pitch * surface->h;
+        SDL_FreeSurface(surface);
+    }
+
+    double cold = 0.0, warm = 0.0;
+    int misses = 0;
+    for (int r = 0; r < rounds; r++) {
+        double start = nowSeconds();
+        for (int i = 0; i < count; i++) {
+            SDL_Surface *surface = decodeImage(paths[i], format);
+            checksum += touchPixels(surface);
+            SDL_FreeSurface(surface);
+        }
+        cold += nowSeconds() - start;
+
+        start = nowSeconds();
+        for (int i = 0; i < count; i++) {
+            SDL_Surface *surface = textureCacheLoad(paths[i], TEXTURE_TIER_FULL, format, NULL);
+            if (!surface) {
+                misses++;
+                continue;
+            }
+            checksum += touchPixels(surface);
+            textureCacheFreeSurface(surface);
+        }
+        warm += nowSeconds() - start;
+    }
+    cold /= rounds;
+    warm /= rounds;
+
+    printf("images: %d (%.1f MB decoded), rounds: %d, checksum: %08x\n", count, bytes / (1024.0 * 1024.0), rounds,
+           checksum);
+    printf("cold, decode + convert: %7.1f ms\n", cold * 1000.0);
+    printf("warm, mapped cache:     %7.1f ms  speedup: %.1fx\n", warm * 1000.0, cold / warm);
+    if (misses > 0) printf("[WARNING] %d cache lookups missed\n", misses);
+
+    IMG_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "../utility/utilities.h"
+
+//measures how fast getRandomWordFromPath() streams through a large word list
+//usage: bench_word_stream [lines] [iterations]
+
+int main(int argc, char *argv[]) {
+    long lines = argc > 1 ? atol(argv[1]) : 500000;
+    int iterations = argc > 2 ? atoi(argv[2]) : 20;
+    const char *path = "bench_word_stream.txt";
+
+    Prng rng;
+    prngSeed(&rng, 1234);
+
+    //generate a word list of random lowercase words
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror("Failed to create word list");
+        return 1;
+    }
+    long bytes = 0;
+    for (long i = 0; i < lines; i++) {
+        char word[16];
+        int len = 4 + prngBounded(&rng, 10);
+        for (int j = 0; j < len; j++) word[j] = (char) ('a' + prngBounded(&rng, 26));
+        word[len] = '\n';
+        fwrite(word, 1, len + 1, file);
+        bytes += len + 1;
+    }
+    fclose(file);
+
+    //warm the page cache so the numbers measure parsing, not the disk
+    free(getRandomWordFromPath(path, &rng));
+
+    double start = nowSeconds();
+    for (int i = 0; i < iterations; i++) {
+        char *word = getRandomWordFromPath(path, &rng);
+        if (!word) {
+            printf("[ERROR] No word returned\n");
+            remove(path);
+            return 1;
+        }
+        free(word);
+    }
+    double elapsed = nowSeconds() - start;
+
+    double megabytes = (double) bytes * iterations / (1024.0 * 1024.0);
+    printf("lines: %ld, file: %.2f MB, iterations: %d\n", lines, bytes / (1024.0 * 1024.0), iterations);
+    printf("time per pick: %.3f ms\n", elapsed * 1000.0 / iterations);
+    printf("throughput: %.1f MB/s\n", megabytes / elapsed);
+
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef BENCH_WORDS_H
+#define BENCH_WORDS_H
+
+#include <stdio.h>
+
+#include "../game/hangman.h"
+#include "../game/solver.h"
+#include "../utility/dictionary.h"
+#include "../utility/prng.h"
+
+//builds a one category dictionary of synthetic words with lengths from minLength to maxLength
+//letters lean toward common ones the way english does, so letter counts and families are uneven
+//path is a scratch word list, it is removed again once the dictionary is built
+static inline bool benchBuildWords(Dictionary *dict, const char *path, long wordCount, int minLength, int maxLength,
+                                   Prng *rng) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror("Failed to create word list");
+        return false;
+    }
+    for (long i = 0; i < wordCount; i++) {
+        char word[MAX_WORD_LEN + 1];
+        int length = minLength;
+        if (maxLength > minLength) length += (int) prngBounded(rng, (uint32_t) (maxLength - minLength + 1));
+        for (int j = 0; j < length; j++) {
+            uint32_t a = prngBounded(rng, ALPHABET_SIZE), b = prngBounded(rng, ALPHABET_SIZE);
+            word[j] = g_letterFrequencyOrder[a < b ? a : b];
+        }
+        word[length] = '\n';
+        fwrite(word, 1, length + 1, file);
+    }
+    fclose(file);
+
+    const char *names[1] = {"synthetic"};
+    const char *paths[1] = {path};
+    bool built = dictionaryBuildFromText(dict, names, paths, 1);
+    remove(path);
+    if (!built) printf("[ERROR] Failed to build dictionary\n");
+    return built;
+}
+
+#endif
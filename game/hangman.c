@@ -4,7 +4,30 @@
 #include <ctype.h>
 
 #include "hangman.h"
+#include "solver.h"
 #include "../utility/utilities.h"
+#include "../utility/bits.h"
+
+/**
+ * Rebuilds the letter masks of the word, called whenever the word is set
+ *
+ * @param game GameState struct that contains the current state of the game
+ */
+static void buildWordMasks(GameState *game) {
+    game->wordLetters = 0;
+    memset(game->letterPositions, 0, sizeof(game->letterPositions));
+    for (int i = 0; game->word[i] != '\0'; i++) {
+        char c = game->word[i];
+        if (c >= 'a' && c <= 'z') {
+            game->wordLetters |= 1u << (c - 'a');
+            game->letterPositions[c - 'a'].bits[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+}
+
+static void evilPartition(GameState *game, char guess);
+
+static void evilFilter(GameState *game, uint32_t shownLetters);
 
 /**
  * Intializes the GameState struct using the default and provided values
@@ -12,14 +35,19 @@
  * @param wordFile pointer to the string containing name of the file
  * @param word pointer to the string containing the word from the file
  * @param lives amount of the initial lives of user when the game start
+ * @param seed seed for the session random generator, the same seed replays the same super blank and power ups
  * @return GameState initialised by the provided and default values
  */
-GameState initHangman(const char *wordFile, const char *word, int lives) {
+GameState initHangman(const char *wordFile, const char *word, int lives, uint64_t seed) {
     GameState game;
 
-    strncpy(game.wordFile, wordFile, MAX_WORD_LEN);
+    prngSeed(&game.rng, seed);
 
-    strncpy(game.word, word, MAX_WORD_LEN);
+    strncpy(game.wordFile, wordFile, MAX_WORD_LEN - 1);
+    game.wordFile[MAX_WORD_LEN - 1] = '\0';
+
+    strncpy(game.word, word, MAX_WORD_LEN - 1);
+    game.word[MAX_WORD_LEN - 1] = '\0';
     stringToLower(game.word);
 
     copyStringToUnderscores(game.revealed, game.word);
@@ -39,7 +67,7 @@ GameState initHangman(const char *wordFile, const char *word, int lives) {
     }
 
     if (count > 0)
-        game.superBlankPos = underscoreIndexes[rand() % count];
+        game.superBlankPos = underscoreIndexes[prngBounded(&game.rng, count)];
     else
         game.superBlankPos = -1;
 
@@ -51,6 +79,16 @@ GameState initHangman(const char *wordFile, const char *word, int lives) {
     game.lives = lives;
     game.shieldActive = 0;
 
+    //build the letter and position masks once, every later check is a bit operation
+    game.guessedSet = 0;
+    buildWordMasks(&game);
+    memset(&game.hidden, 0, sizeof(game.hidden));
+    for (int i = 0; i < len; i++) {
+        if (game.revealed[i] != ' ')
+            game.hidden.bits[i / 64] |= 1ULL << (i % 64);
+    }
+
+    game.evil = NULL;
     return game;
 }
 
@@ -66,13 +104,33 @@ bool validateGuess(const GameState *game, char guess) {
         return false;
 
     guess = tolower(guess);
+    if (guess < 'a' || guess > 'z')
+        return false;
 
-    if (charInArray(game->guessed, guess, game->numGuessed))
+    if (game->guessedSet & (1u << (guess - 'a')))
         return false;
 
     return true;
 }
 
+/**
+ * Reveals every position in mask, and marks them as no longer hidden
+ *
+ * @param game GameState struct that contains the current state of the game
+ * @param mask positions to reveal
+ */
+static void revealPositions(GameState *game, const PositionMask *mask) {
+    for (int w = 0; w < POSITION_MASK_WORDS; w++) {
+        uint64_t bits = mask->bits[w];
+        game->hidden.bits[w] &= ~bits;
+        while (bits) {
+            int i = w * 64 + lowestBitIndex64(bits);
+            game->revealed[i] = game->word[i];
+            bits &= bits - 1;
+        }
+    }
+}
+
 /**
  * Checks if guess is correct or not, or if correct is it a super blank or not
  *
@@ -83,10 +141,19 @@ bool validateGuess(const GameState *game, char guess) {
 bool processGuess(GameState *game, char guess) {
     guess = tolower(guess);
 
-    bool found = stringHasChar(game->word, guess);
+    bool found = false;
+    if (guess >= 'a' && guess <= 'z') {
+        uint32_t bit = 1u << (guess - 'a');
+        //in evil mode the word is only settled now, to the largest family of candidates
+        if (game->evil && !(game->guessedSet & bit))
+            evilPartition(game, guess);
+
+        game->guessedSet |= bit;
+        found = (game->wordLetters & bit) != 0;
+    }
 
     if (found) {
-        revealGuessedLetter(game->word, game->revealed, guess);
+        revealPositions(game, &game->letterPositions[guess - 'a']);
 
         // checks if guess is super blank
         if (game->superBlankPos != -1 && game->word[game->superBlankPos] == guess) {
@@ -112,7 +179,9 @@ bool processGuess(GameState *game, char guess) {
  * @return if word is completely revealed (hence won)
  */
 bool isGameWon(const GameState *game) {
-    return isWordFullyRevealed(game->revealed);
+    uint64_t hidden = 0;
+    for (int w = 0; w < POSITION_MASK_WORDS; w++) hidden |= game->hidden.bits[w];
+    return hidden == 0;
 }
 
 /**
@@ -161,10 +230,62 @@ const char *getGuessedLetters(const GameState *game) {
  * @param wordFile pointer to the string containing name of the file
  * @param word pointer to the string containing the word from the file
  * @param lives amount of the initial lives of user when the game start
+ * @param seed seed for the session random generator
  * @return GameState initialised by the provided and default values using the initHangman() function
  */
-GameState resetGame(const char *wordFile, const char *word, int lives) {
-    return initHangman(wordFile, word, lives);
+GameState resetGame(const char *wordFile, const char *word, int lives, uint64_t seed) {
+    return initHangman(wordFile, word, lives, seed);
+}
+
+/**
+ * Reveals one random blank ('_') of the word, the super blank is never picked
+ *
+ * @param game GameState struct that contains the current state of the game
+ * @return true if a blank was revealed, false if none were left
+ */
+bool revealRandomBlank(GameState *game) {
+    PositionMask blanks = game->hidden;
+    if (game->superBlankPos != -1)
+        blanks.bits[game->superBlankPos / 64] &= ~(1ULL << (game->superBlankPos % 64));
+
+    int count = 0;
+    for (int w = 0; w < POSITION_MASK_WORDS; w++) count += bitCount64(blanks.bits[w]);
+    if (count == 0) return false;
+
+    //pick the n-th blank and keep only its bit
+    int n = prngBounded(&game->rng, count);
+    for (int w = 0; w < POSITION_MASK_WORDS; w++) {
+        int wordCount = bitCount64(blanks.bits[w]);
+        if (n < wordCount) {
+            PositionMask single = {0};
+            single.bits[w] = 1ULL << nthBitIndex64(blanks.bits[w], n);
+            revealPositions(game, &single);
+            break;
+        }
+        n -= wordCount;
+    }
+
+    if (game->evil)
+        evilFilter(game, game->guessedSet);
+    return true;
+}
+
+/**
+ * Reveals every vowel of the word
+ *
+ * @param game GameState struct that contains the current state of the game
+ */
+void revealVowels(GameState *game) {
+    static const char vowels[] = "aeiou";
+    uint32_t vowelSet = 0;
+    for (int v = 0; vowels[v] != '\0'; v++) {
+        revealPositions(game, &game->letterPositions[vowels[v] - 'a']);
+        vowelSet |= 1u << (vowels[v] - 'a');
+    }
+
+    //no candidate may hide a vowel behind a blank from now on
+    if (game->evil)
+        evilFilter(game, game->guessedSet | vowelSet);
 }
 
 /**
@@ -175,24 +296,10 @@ GameState resetGame(const char *wordFile, const char *word, int lives) {
  */
 void activatePowerUp(GameState *game, int power_id) {
     switch (power_id) {
-        case 1: {
-            // reveals random blank
-            int len = strlen(game->word);
-            int validIndexes[MAX_WORD_LEN];
-            int count = 0;
-
-            for (int i = 0; i < len; i++) {
-                if (game->revealed[i] == '_')
-                    validIndexes[count++] = i;
-            }
-
-            if (count > 0) {
-                int idx = validIndexes[rand() % count];
-                game->revealed[idx] = game->word[idx];
+        case 1: // reveals random blank
+            if (revealRandomBlank(game))
                 printf("Power-Up: A random letter was revealed!\n");
-            }
-        }
-        break;
+            break;
 
         case 2: // gives extra life
             game->lives++;
@@ -200,11 +307,7 @@ void activatePowerUp(GameState *game, int power_id) {
             break;
 
         case 3: // shows all vowels
-            for (int i = 0; game->word[i] != '\0'; i++) {
-                char c = game->word[i];
-                if (c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u')
-                    game->revealed[i] = c;
-            }
+            revealVowels(game);
             printf("Power-Up: All vowels revealed!\n");
             break;
 
@@ -215,11 +318,11 @@ void activatePowerUp(GameState *game, int power_id) {
 
         case 5: {
             // funny chance power
-            int roll = rand() % 100 + 1;
+            int roll = prngBounded(&game->rng, 100) + 1;
 
             if (roll <= 5) {
                 printf("Bonus random power up!\n");
-                activatePowerUp(game, rand() % 4 + 1);
+                activatePowerUp(game, prngBounded(&game->rng, 4) + 1);
             } else if (roll <= 10) {
                 game->lives--;
                 printf("Lost 1 life.\n");
@@ -228,6 +331,10 @@ void activatePowerUp(GameState *game, int power_id) {
             }
         }
         break;
+
+        case 6: // suggests the letter expected to leave the fewest words
+            printf("Power-Up: Smart hint, try '%c'!\n", solverSmartHint(game));
+            break;
     }
 }
 
@@ -244,14 +351,14 @@ void powerUpMenu(GameState *game) {
     for (int i = 0; i < 9; i++) boxPower[i] = 0;
 
     // choose 3 positions
-    int pos1 = rand() % 9, pos2 = rand() % 9, pos3 = rand() % 9;
-    while (pos2 == pos1) pos2 = rand() % 9;
-    while (pos3 == pos1 || pos3 == pos2) pos3 = rand() % 9;
+    int pos1 = prngBounded(&game->rng, 9), pos2 = prngBounded(&game->rng, 9), pos3 = prngBounded(&game->rng, 9);
+    while (pos2 == pos1) pos2 = prngBounded(&game->rng, 9);
+    while (pos3 == pos1 || pos3 == pos2) pos3 = prngBounded(&game->rng, 9);
 
     // assigns random power ids
-    boxPower[pos1] = rand() % 5 + 1;
-    boxPower[pos2] = rand() % 5 + 1;
-    boxPower[pos3] = rand() % 5 + 1;
+    boxPower[pos1] = prngBounded(&game->rng, 6) + 1;
+    boxPower[pos2] = prngBounded(&game->rng, 6) + 1;
+    boxPower[pos3] = prngBounded(&game->rng, 6) + 1;
 
     // displays boxes
     for (int i = 1; i <= 9; i++) {
@@ -278,3 +385,204 @@ void powerUpMenu(GameState *game) {
         printf("Empty box, no power up.\n");
     }
 }
+
+/**
+ * Starts an evil game, the word is not fixed and dodges the player's guesses for as long as the dictionary allows
+ * The candidates are the words of the category with the same length and space layout as the starting word
+ *
+ * @param evil EvilHangman struct that receives the candidates, must outlive the game
+ * @param dict dictionary the candidates come from
+ * @param category index of the category inside dict
+ * @param word starting word, shown as the answer until the first guess
+ * @param lives amount of the initial lives of user when the game start
+ * @param seed seed for the session random generator
+ * @return GameState of the evil game, a normal game of the starting word if memory ran out
+ */
+GameState initEvilHangman(EvilHangman *evil, const Dictionary *dict, int category, const char *word, int lives,
+                          uint64_t seed) {
+    GameState game = initHangman(dictionaryCategoryName(dict, category), word, lives, seed);
+
+    memset(evil, 0, sizeof(*evil));
+    evil->dict = dict;
+
+    uint32_t first, count;
+    dictionaryLengthRange(dict, category, (int) strlen(game.word), &first, &count);
+
+    //sized for the first guess, the largest partition the game will ever do
+    evil->bucketCapacity = 16;
+    while (evil->bucketCapacity < count * 2) evil->bucketCapacity <<= 1;
+
+    evil->candidates = malloc((count ? count : 1) * sizeof(uint32_t));
+    evil->bucketOf = malloc((count ? count : 1) * sizeof(uint32_t));
+    evil->buckets = calloc(evil->bucketCapacity, sizeof(EvilBucket));
+    if (!evil->candidates || !evil->bucketOf || !evil->buckets) {
+        printf("[ERROR] Not enough memory for evil hangman, playing a normal game\n");
+        evilHangmanDestroy(evil);
+        return game;
+    }
+
+    for (uint32_t i = 0; i < count; i++) evil->candidates[i] = first + i;
+    evil->candidateCount = count;
+
+    //drops the words whose spaces sit elsewhere, a word outside the dictionary stays a normal game
+    game.evil = evil;
+    evilFilter(&game, 0);
+    if (evil->candidateCount == 0) {
+        evilHangmanDestroy(evil);
+        game.evil = NULL;
+    }
+    return game;
+}
+
+/**
+ * Frees the candidate buffers, games that point at evil must not be played afterwards
+ *
+ * @param evil EvilHangman struct to release
+ */
+void evilHangmanDestroy(EvilHangman *evil) {
+    free(evil->candidates);
+    free(evil->bucketOf);
+    free(evil->buckets);
+    memset(evil, 0, sizeof(*evil));
+}
+
+/**
+ * @param game GameState struct that contains the current state of the game
+ * @return number of words the evil word could still be, 1 for a normal game
+ */
+uint32_t evilHangmanCandidateCount(const GameState *game) {
+    return game->evil ? game->evil->candidateCount : 1;
+}
+
+/**
+ * Orders families from the evil point of view: more candidates first, then fewer revealed positions
+ * The last tie break on the key itself makes the choice independent of the candidate order
+ */
+static bool isWorseForPlayer(const EvilBucket *a, const EvilBucket *b) {
+    if (a->count != b->count) return a->count > b->count;
+
+    int revealedA = 0, revealedB = 0;
+    for (int w = 0; w < POSITION_MASK_WORDS; w++) {
+        revealedA += bitCount64(a->key.bits[w]);
+        revealedB += bitCount64(b->key.bits[w]);
+    }
+    if (revealedA != revealedB) return revealedA < revealedB;
+
+    for (int w = POSITION_MASK_WORDS - 1; w >= 0; w--) {
+        if (a->key.bits[w] != b->key.bits[w]) return a->key.bits[w] < b->key.bits[w];
+    }
+    return false;
+}
+
+/**
+ * Switches the word to a new stand in, the revealed string stays valid because every candidate agrees with it
+ */
+static void evilLoadWord(GameState *game, uint32_t wordIndex) {
+    strncpy(game->word, dictionaryWordString(game->evil->dict, wordIndex), MAX_WORD_LEN - 1);
+    game->word[MAX_WORD_LEN - 1] = '\0';
+    buildWordMasks(game);
+}
+
+/**
+ * Buckets the candidates by the positions the guess would reveal in each of them and keeps the largest bucket
+ * Runs in one pass over the candidates plus one compaction pass, without allocating
+ *
+ * @param game GameState struct of an evil game
+ * @param guess lowercase letter that was not guessed before
+ */
+static void evilPartition(GameState *game, char guess) {
+    EvilHangman *evil = game->evil;
+    const Dictionary *dict = evil->dict;
+    uint32_t bit = 1u << (guess - 'a');
+    uint32_t count = evil->candidateCount;
+
+    //the table shrinks with the candidates, so late guesses only touch a few cache lines
+    uint32_t capacity = 16;
+    while (capacity < count * 2 && capacity < evil->bucketCapacity) capacity <<= 1;
+    uint32_t tableMask = capacity - 1;
+
+    if (++evil->stamp == 0) {
+        memset(evil->buckets, 0, evil->bucketCapacity * sizeof(EvilBucket));
+        evil->stamp = 1;
+    }
+    uint32_t stamp = evil->stamp;
+
+    uint32_t best = 0, bestCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t w = evil->candidates[i];
+
+        //the letter mask rules out words without reading their string, hits are scanned without branches
+        PositionMask key = {0};
+        if (dict->words[w].letterMask & bit) {
+            const char *s = dictionaryWordString(dict, w);
+            for (int j = 0; j < dict->words[w].length; j++) {
+                key.bits[j / 64] |= (uint64_t) (s[j] == guess) << (j % 64);
+            }
+        }
+
+        uint32_t h = hashPositionMask(&key) & tableMask;
+        for (;;) {
+            EvilBucket *bucket = &evil->buckets[h];
+            if (bucket->stamp != stamp) {
+                bucket->stamp = stamp;
+                bucket->key = key;
+                bucket->count = 0;
+                break;
+            }
+            if (positionMaskEquals(&bucket->key, &key)) break;
+            h = (h + 1) & tableMask;
+        }
+
+        //counts only grow, so the full comparison is only needed when a family catches up with the best one
+        uint32_t bucketCount = ++evil->buckets[h].count;
+        evil->bucketOf[i] = h;
+        if (bucketCount > bestCount) {
+            best = h;
+            bestCount = bucketCount;
+        } else if (bucketCount == bestCount && h != best &&
+                   isWorseForPlayer(&evil->buckets[h], &evil->buckets[best])) {
+            best = h;
+        }
+    }
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (evil->bucketOf[i] == best) evil->candidates[kept++] = evil->candidates[i];
+    }
+    evil->candidateCount = kept;
+
+    //any member of the family can stand in for the word
+    evilLoadWord(game, evil->candidates[prngBounded(&game->rng, kept)]);
+}
+
+/**
+ * Drops the candidates that disagree with what the player can see, used after power ups revealed positions
+ * The current word always survives, since everything shown was taken from it
+ *
+ * @param game GameState struct of an evil game
+ * @param shownLetters letters that are fully shown, no candidate may have them behind a blank
+ */
+static void evilFilter(GameState *game, uint32_t shownLetters) {
+    EvilHangman *evil = game->evil;
+    const Dictionary *dict = evil->dict;
+    int length = (int) strlen(game->word);
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < evil->candidateCount; i++) {
+        uint32_t w = evil->candidates[i];
+        const char *s = dictionaryWordString(dict, w);
+
+        bool matches = true;
+        for (int j = 0; j < length && matches; j++) {
+            if ((game->hidden.bits[j / 64] >> (j % 64)) & 1) {
+                bool shown = s[j] >= 'a' && s[j] <= 'z' && (shownLetters & (1u << (s[j] - 'a')));
+                matches = s[j] != ' ' && !shown;
+            } else {
+                matches = s[j] == game->word[j];
+            }
+        }
+
+        if (matches) evil->candidates[kept++] = w;
+    }
+    evil->candidateCount = kept;
+}
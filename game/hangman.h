@@ -2,9 +2,51 @@
 #define HANGMAN_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "../utility/prng.h"
+#include "../utility/dictionary.h"
 
 #define MAX_WORD_LEN 128
 #define MAX_GUESSED 64
+#define ALPHABET_SIZE 26
+#define POSITION_MASK_WORDS (MAX_WORD_LEN / 64)
+
+//one bit per character position of the word
+typedef struct {
+    uint64_t bits[POSITION_MASK_WORDS];
+} PositionMask;
+
+static inline uint32_t hashPositionMask(const PositionMask *mask) {
+    uint64_t h = mask->bits[0] * 0x9E3779B97F4A7C15ULL;
+    for (int w = 1; w < POSITION_MASK_WORDS; w++) h ^= mask->bits[w] * 0xC2B2AE3D27D4EB4FULL;
+    return (uint32_t) (h >> 32);
+}
+
+static inline bool positionMaskEquals(const PositionMask *a, const PositionMask *b) {
+    for (int w = 0; w < POSITION_MASK_WORDS; w++) {
+        if (a->bits[w] != b->bits[w]) return false;
+    }
+    return true;
+}
+
+//one family of candidates, keyed by the positions a guess would reveal, used by the evil partition and the smart hint
+typedef struct {
+    PositionMask key;
+    uint32_t count;
+    uint32_t stamp;
+} EvilBucket;
+
+//candidate words of an evil game, every buffer is allocated when the game starts so guesses never allocate
+typedef struct {
+    const Dictionary *dict;
+    uint32_t *candidates;    //word indexes that still agree with everything the player has seen
+    uint32_t candidateCount;
+    uint32_t *bucketOf;      //bucket of each candidate while partitioning
+    EvilBucket *buckets;     //open addressing table, capacity is a power of two
+    uint32_t bucketCapacity;
+    uint32_t stamp;          //buckets with an older stamp are empty, so the table is never cleared
+} EvilHangman;
 
 typedef struct {
     char wordFile[MAX_WORD_LEN];
@@ -15,11 +57,20 @@ typedef struct {
     int lives;
     int shieldActive;
     int superBlankPos;
+    Prng rng; //per session generator for super blank and power ups
+
+    //bit sets kept in sync with the strings above so guesses never scan them
+    uint32_t guessedSet;                          //bit i is set once 'a' + i was guessed
+    uint32_t wordLetters;                         //bit i is set when 'a' + i is in the word
+    PositionMask letterPositions[ALPHABET_SIZE];  //where each letter appears in the word
+    PositionMask hidden;                          //positions still shown as '_' or '~'
+
+    EvilHangman *evil; //NULL for a normal game, else word is only the current stand in of the candidates
 } GameState;
 
 
 // hangman
-GameState initHangman(const char *wordFile, const char *word, int lives);
+GameState initHangman(const char *wordFile, const char *word, int lives, uint64_t seed);
 
 bool processGuess(GameState *game, char guess);
 
@@ -35,7 +86,19 @@ int getRemainingLives(const GameState *game);
 
 const char *getGuessedLetters(const GameState *game);
 
-GameState resetGame(const char *wordFile, const char *word, int lives);
+GameState resetGame(const char *wordFile, const char *word, int lives, uint64_t seed);
+
+bool revealRandomBlank(GameState *game);
+
+void revealVowels(GameState *game);
+
+// evil hangman
+GameState initEvilHangman(EvilHangman *evil, const Dictionary *dict, int category, const char *word, int lives,
+                          uint64_t seed);
+
+void evilHangmanDestroy(EvilHangman *evil);
+
+uint32_t evilHangmanCandidateCount(const GameState *game);
 
 // powers
 void powerUpMenu(GameState *game);
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "session_pool.h"
+#include "../utility/bits.h"
+#include "../utility/prng.h"
+
+_Static_assert(sizeof(HangmanSession) <= 64, "HangmanSession must stay within one cache line");
+
+static inline HangmanSession *slotPointer(const SessionPool *pool, uint32_t slot) {
+    return &pool->slabs[slot >> SESSION_SLAB_SHIFT][slot & (SESSION_SLAB_SIZE - 1)];
+}
+
+/**
+ * Prepares an empty pool, no memory is allocated until the first session is created
+ *
+ * @param pool SessionPool struct to initialise
+ * @param dict dictionary that session word indexes refer to, must outlive the pool
+ * @return true if the pool is ready
+ */
+bool sessionPoolInit(SessionPool *pool, const Dictionary *dict) {
+    memset(pool, 0, sizeof(*pool));
+    pool->dict = dict;
+    return dict != NULL && dict->header != NULL;
+}
+
+/**
+ * Frees every slab, all handles and session pointers become invalid
+ *
+ * @param pool SessionPool struct to release
+ */
+void sessionPoolDestroy(SessionPool *pool) {
+    for (uint32_t i = 0; i < pool->slabCount; i++) {
+        free(pool->slabs[i]);
+    }
+    free(pool->slabs);
+    memset(pool, 0, sizeof(*pool));
+}
+
+/**
+ * Takes a slot from the free list, or from the end of the last slab, adding a slab when all are full
+ *
+ * @return slot index, or UINT32_MAX if memory ran out
+ */
+static uint32_t takeSlot(SessionPool *pool) {
+    if (pool->freeHead != 0) {
+        uint32_t slot = pool->freeHead - 1;
+        pool->freeHead = slotPointer(pool, slot)->wordIndex;
+        return slot;
+    }
+
+    if (pool->usedSlots == pool->slabCount * (uint32_t) SESSION_SLAB_SIZE) {
+        if (pool->slabCount == pool->slabCapacity) {
+            uint32_t newCapacity = pool->slabCapacity ? pool->slabCapacity * 2 : 16;
+            HangmanSession **newSlabs = realloc(pool->slabs, newCapacity * sizeof(HangmanSession *));
+            if (!newSlabs) return UINT32_MAX;
+            pool->slabs = newSlabs;
+            pool->slabCapacity = newCapacity;
+        }
+
+        HangmanSession *slab = calloc(SESSION_SLAB_SIZE, sizeof(HangmanSession));
+        if (!slab) return UINT32_MAX;
+        pool->slabs[pool->slabCount++] = slab;
+    }
+
+    return pool->usedSlots++;
+}
+
+/**
+ * Starts a new compact session, the same work initHangman() does for a GameState
+ *
+ * @param pool pool to allocate from
+ * @param wordIndex global index of the word inside the pool dictionary
+ * @param lives amount of the initial lives of user when the game start
+ * @param seed seed for the session random generator
+ * @return handle of the session, or SESSION_INVALID_HANDLE if the word is unknown or longer than SESSION_MAX_WORD_LEN
+ */
+SessionHandle sessionCreate(SessionPool *pool, uint32_t wordIndex, int lives, uint64_t seed) {
+    const DictionaryWord *info = dictionaryWordInfo(pool->dict, wordIndex);
+    const char *word = dictionaryWordString(pool->dict, wordIndex);
+    if (!info || !word || info->length > SESSION_MAX_WORD_LEN) return SESSION_INVALID_HANDLE;
+
+    uint32_t slot = takeSlot(pool);
+    if (slot == UINT32_MAX) return SESSION_INVALID_HANDLE;
+
+    HangmanSession *session = slotPointer(pool, slot);
+    session->wordIndex = wordIndex;
+    session->guessedSet = 0;
+    session->rngState = seed;
+    session->category = (uint16_t) dictionaryWordCategory(pool->dict, wordIndex);
+    session->lives = (int8_t) lives;
+    session->flags = SESSION_FLAG_LIVE;
+
+    //every character except spaces starts hidden
+    session->hidden = 0;
+    for (int i = 0; i < info->length; i++) {
+        if (word[i] != ' ') session->hidden |= 1ULL << i;
+    }
+
+    //makes random blank a super blank
+    int count = bitCount64(session->hidden);
+    if (count > 0) {
+        int n = (int) (((prngSplitMix64(&session->rngState) >> 32) * (uint64_t) count) >> 32);
+        session->superBlankPos = (int8_t) nthBitIndex64(session->hidden, n);
+    } else {
+        session->superBlankPos = -1;
+    }
+
+    pool->liveCount++;
+    return ((uint64_t) session->generation << 32) | (uint64_t) (slot + 1);
+}
+
+/**
+ * Ends a session and returns its slot to the pool, stale handles to it are rejected from now on
+ * A slot that used up every generation is retired instead, so a handle can never match a later session
+ *
+ * @param pool pool the session came from
+ * @param handle handle returned by sessionCreate()
+ */
+void sessionDestroy(SessionPool *pool, SessionHandle handle) {
+    HangmanSession *session = sessionGet(pool, handle);
+    if (!session) return;
+
+    uint32_t slot = (uint32_t) handle - 1;
+    session->flags = 0;
+    pool->liveCount--;
+    if (session->generation == UINT32_MAX) return;
+
+    session->generation++;
+    session->wordIndex = pool->freeHead;
+    pool->freeHead = slot + 1;
+}
+
+/**
+ * @param pool pool the session came from
+ * @param handle handle returned by sessionCreate()
+ * @return the session, or NULL if the handle is invalid or the session was destroyed
+ */
+HangmanSession *sessionGet(const SessionPool *pool, SessionHandle handle) {
+    uint32_t low = (uint32_t) handle;
+    if (low == 0 || low > pool->usedSlots) return NULL;
+
+    HangmanSession *session = slotPointer(pool, low - 1);
+    if (!(session->flags & SESSION_FLAG_LIVE) || session->generation != (uint32_t) (handle >> 32)) return NULL;
+    return session;
+}
+
+/**
+ * @return bytes allocated by the pool, live or free
+ */
+size_t sessionPoolMemoryUsage(const SessionPool *pool) {
+    return (size_t) pool->slabCount * SESSION_SLAB_SIZE * sizeof(HangmanSession) +
+           (size_t) pool->slabCapacity * sizeof(HangmanSession *);
+}
+
+/**
+ * Validates Guesses if they are eligible to be processed or not
+ *
+ * @param session compact session
+ * @param guess character the user has guessed
+ * @return false if the character was already guessed or is not alphabet, else true
+ */
+bool sessionValidateGuess(const HangmanSession *session, char guess) {
+    if (!isalpha(guess)) return false;
+
+    guess = tolower(guess);
+    if (guess < 'a' || guess > 'z') return false;
+
+    return !(session->guessedSet & (1u << (guess - 'a')));
+}
+
+/**
+ * Applies a guess to a compact session, same rules as processGuess()
+ *
+ * @param pool pool the session came from, used to look up the word
+ * @param session compact session
+ * @param guess character the user has guessed
+ * @return true if the guess uncovered the super blank, else false
+ */
+bool sessionProcessGuess(const SessionPool *pool, HangmanSession *session, char guess) {
+    guess = tolower(guess);
+
+    bool found = false;
+    if (guess >= 'a' && guess <= 'z') {
+        uint32_t bit = 1u << (guess - 'a');
+        session->guessedSet |= bit;
+        found = (pool->dict->words[session->wordIndex].letterMask & bit) != 0;
+    }
+
+    if (found) {
+        //the letter mask already said it is there, so only hits pay for the scan
+        const char *word = dictionaryWordString(pool->dict, session->wordIndex);
+        uint64_t positions = 0;
+        for (int i = 0; word[i] != '\0'; i++) {
+            if (word[i] == guess) positions |= 1ULL << i;
+        }
+        session->hidden &= ~positions;
+
+        // checks if guess is super blank
+        if (session->superBlankPos != -1 && (positions >> session->superBlankPos) & 1) {
+            session->superBlankPos = -1; // super blank is used up
+            return true;
+        }
+        return false;
+    }
+
+    if (session->flags & SESSION_FLAG_SHIELD) {
+        session->flags &= ~SESSION_FLAG_SHIELD;
+    } else {
+        session->lives--;
+    }
+    return false;
+}
+
+bool sessionIsWon(const HangmanSession *session) {
+    return session->hidden == 0;
+}
+
+bool sessionIsOver(const HangmanSession *session) {
+    return sessionIsWon(session) || session->lives <= 0;
+}
+
+/**
+ * Builds the revealed word on demand, it is not stored inside the session
+ *
+ * @param pool pool the session came from, used to look up the word
+ * @param session compact session
+ * @param out buffer that receives the word with '_' blanks and '~' for the super blank
+ * @param size size of out
+ */
+void sessionGetRevealedWord(const SessionPool *pool, const HangmanSession *session, char *out, size_t size) {
+    if (size == 0) return;
+
+    const char *word = dictionaryWordString(pool->dict, session->wordIndex);
+    size_t i = 0;
+    for (; word[i] != '\0' && i < size - 1; i++) {
+        if ((session->hidden >> i) & 1) out[i] = (int) i == session->superBlankPos ? '~' : '_';
+        else out[i] = word[i];
+    }
+    out[i] = '\0';
+}
@@ -0,0 +1,67 @@
+#ifndef SESSION_POOL_H
+#define SESSION_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../utility/dictionary.h"
+
+#define SESSION_MAX_WORD_LEN 64
+#define SESSION_SLAB_SHIFT 12
+#define SESSION_SLAB_SIZE (1 << SESSION_SLAB_SHIFT)
+
+#define SESSION_FLAG_LIVE 0x01
+#define SESSION_FLAG_SHIELD 0x02
+
+//0 is never a valid handle, low 32 bits are slot + 1, high 32 bits are the slot generation
+typedef uint64_t SessionHandle;
+#define SESSION_INVALID_HANDLE 0
+
+//compact game state for servers, the word is referenced by dictionary index instead of copied
+typedef struct {
+    uint32_t wordIndex;  //global dictionary word index, next free slot while the slot is unused
+    uint32_t guessedSet; //bit i is set once 'a' + i was guessed
+    uint64_t hidden;     //positions still shown as '_' or '~'
+    uint64_t rngState;   //splitmix64 state for power ups
+    uint32_t generation; //fills the high 32 bits of the handle, the slot is retired before it would wrap
+    uint16_t category;
+    int8_t superBlankPos;
+    int8_t lives;
+    uint8_t flags;
+} HangmanSession;
+
+//sessions live in fixed size slabs that never move, so pointers and handles stay valid until destroyed
+typedef struct {
+    const Dictionary *dict;
+    HangmanSession **slabs;
+    uint32_t slabCount;
+    uint32_t slabCapacity;
+    uint32_t freeHead; //slot + 1 of the first free slot, 0 when the list is empty
+    uint32_t usedSlots;
+    uint32_t liveCount;
+} SessionPool;
+
+bool sessionPoolInit(SessionPool *pool, const Dictionary *dict);
+
+void sessionPoolDestroy(SessionPool *pool);
+
+SessionHandle sessionCreate(SessionPool *pool, uint32_t wordIndex, int lives, uint64_t seed);
+
+void sessionDestroy(SessionPool *pool, SessionHandle handle);
+
+HangmanSession *sessionGet(const SessionPool *pool, SessionHandle handle);
+
+size_t sessionPoolMemoryUsage(const SessionPool *pool);
+
+bool sessionValidateGuess(const HangmanSession *session, char guess);
+
+bool sessionProcessGuess(const SessionPool *pool, HangmanSession *session, char guess);
+
+bool sessionIsWon(const HangmanSession *session);
+
+bool sessionIsOver(const HangmanSession *session);
+
+void sessionGetRevealedWord(const SessionPool *pool, const HangmanSession *session, char *out, size_t size);
+
+#endif
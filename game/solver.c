@@ -0,0 +1,986 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "solver.h"
+#include "../utility/bits.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOLVER_SSE2 1
+#else
+#define SOLVER_SSE2 0
+#endif
+
+//english letters from most to least common
+const char g_letterFrequencyOrder[] = "etaoinshrdlcumwfgypbvkjxqz";
+
+const Strategy g_strategies[] = {
+    {"random", strategyRandomGuess},
+    {"frequency", strategyFrequencyGuess},
+    {"candidates", strategyCandidateGuess},
+};
+const int g_strategyCount = sizeof(g_strategies) / sizeof(g_strategies[0]);
+
+/**
+ * Guesses a uniformly random letter that was not guessed yet
+ */
+char strategyRandomGuess(const GameState *game, const SolverContext *context, Prng *rng) {
+    uint32_t remaining = ~game->guessedSet & ((1u << ALPHABET_SIZE) - 1);
+    int count = bitCount32(remaining);
+    if (count == 0) return 'a';
+    return (char) ('a' + nthBitIndex64(remaining, prngBounded(rng, count)));
+}
+
+/**
+ * Guesses the most common english letter that was not guessed yet
+ */
+char strategyFrequencyGuess(const GameState *game, const SolverContext *context, Prng *rng) {
+    for (int i = 0; g_letterFrequencyOrder[i] != '\0'; i++) {
+        char c = g_letterFrequencyOrder[i];
+        if (!(game->guessedSet & (1u << (c - 'a')))) return c;
+    }
+    return 'a';
+}
+
+/**
+ * Checks if a dictionary word could still be the hidden word
+ *
+ * @param candidate lowercase dictionary word of the same length as revealed
+ * @param revealed the word that player has guessed thus far
+ * @param guessedSet letters guessed so far, none of them can sit behind a blank
+ * @return true if the candidate agrees with every revealed and hidden position
+ */
+static bool matchesPattern(const char *candidate, const char *revealed, uint32_t guessedSet) {
+    for (int i = 0; revealed[i] != '\0'; i++) {
+        char r = revealed[i];
+        char c = candidate[i];
+        if (r == '_' || r == '~') {
+            if (c == ' ') return false;
+            if (c >= 'a' && c <= 'z' && (guessedSet & (1u << (c - 'a')))) return false;
+        } else if (c != r) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Counts the category words that are still consistent with the game, and how many of them contain each letter
+ *
+ * @param game GameState struct that contains the current state of the game
+ * @param context dictionary and category to search
+ * @param letterCounts receives, per letter, the number of candidates that contain it
+ * @return number of candidates
+ */
+int solverCountCandidates(const GameState *game, const SolverContext *context, uint32_t letterCounts[ALPHABET_SIZE]) {
+    memset(letterCounts, 0, ALPHABET_SIZE * sizeof(uint32_t));
+
+    const char *revealed = game->revealed;
+    int length = (int) strlen(revealed);
+    uint32_t first, count;
+    if (!dictionaryLengthRange(context->dict, context->category, length, &first, &count)) return 0;
+
+    //letters on screen must be in the word, guessed letters that are not on screen must not
+    uint32_t shown = dictionaryLetterMask(revealed, NULL, NULL);
+    uint32_t excluded = game->guessedSet & ~shown;
+
+    int candidates = 0;
+    for (uint32_t i = first; i < first + count; i++) {
+        uint32_t mask = context->dict->words[i].letterMask;
+        if ((mask & excluded) || (mask & shown) != shown) continue;
+        if (!matchesPattern(dictionaryWordString(context->dict, i), revealed, game->guessedSet)) continue;
+
+        candidates++;
+        for (uint32_t m = mask & ~game->guessedSet; m; m &= m - 1) {
+            letterCounts[lowestBitIndex64(m)]++;
+        }
+    }
+
+    return candidates;
+}
+
+/**
+ * Reference solver: guesses the letter found in the most words that still fit the pattern
+ * Falls back to letter frequency when the word is not in the dictionary
+ */
+char strategyCandidateGuess(const GameState *game, const SolverContext *context, Prng *rng) {
+    uint32_t letterCounts[ALPHABET_SIZE];
+    if (solverCountCandidates(game, context, letterCounts) == 0) return strategyFrequencyGuess(game, context, rng);
+
+    //scanning in frequency order breaks ties toward common letters
+    char best = 0;
+    uint32_t bestCount = 0;
+    for (int i = 0; g_letterFrequencyOrder[i] != '\0'; i++) {
+        char c = g_letterFrequencyOrder[i];
+        if (letterCounts[c - 'a'] > bestCount) {
+            bestCount = letterCounts[c - 'a'];
+            best = c;
+        }
+    }
+
+    return best ? best : strategyFrequencyGuess(game, context, rng);
+}
+
+static bool splitHintNode(SolverIndex *index, SolverLengthGroup *group, uint32_t nodeIndex, char *revealed,
+                          uint32_t guessedSet, uint8_t *runColumns, uint32_t *runMasks);
+
+/**
+ * Builds the column major index of every category, grouped by word length
+ * The groups of short words with at least SOLVER_TREE_MIN_WORDS words also get their hint tree
+ *
+ * @param index SolverIndex struct to fill
+ * @param dict dictionary to index, must outlive the index
+ * @return true if the index was built, false if memory ran out
+ */
+bool solverIndexBuild(SolverIndex *index, const Dictionary *dict) {
+    memset(index, 0, sizeof(*index));
+    index->dict = dict;
+    index->categoryCount = dictionaryCategoryCount(dict);
+    index->categories = calloc(index->categoryCount ? index->categoryCount : 1, sizeof(SolverCategoryIndex));
+    if (!index->categories) return false;
+
+    uint32_t maxStride = SOLVER_LANES;
+    uint32_t maxTreeBytes = 0;
+    for (int c = 0; c < index->categoryCount; c++) {
+        SolverCategoryIndex *category = &index->categories[c];
+        uint32_t first = dict->categories[c].firstWord;
+        uint32_t end = first + dict->categories[c].wordCount;
+
+        //words are sorted by length inside a category, so every length is one run
+        for (uint32_t i = first; i < end; i++) {
+            if (i == first || dict->words[i].length != dict->words[i - 1].length) category->groupCount++;
+        }
+        category->groups = calloc(category->groupCount ? category->groupCount : 1, sizeof(SolverLengthGroup));
+        if (!category->groups) {
+            solverIndexDestroy(index);
+            return false;
+        }
+
+        int g = -1;
+        for (uint32_t i = first; i < end; i++) {
+            if (i == first || dict->words[i].length != dict->words[i - 1].length) {
+                g++;
+                category->groups[g].length = dict->words[i].length;
+                category->groups[g].firstWord = i;
+            }
+            category->groups[g].count++;
+        }
+
+        for (g = 0; g < category->groupCount; g++) {
+            SolverLengthGroup *group = &category->groups[g];
+            group->stride = (group->count + SOLVER_LANES - 1) / SOLVER_LANES * SOLVER_LANES;
+            group->letterMasks = calloc(group->stride, sizeof(uint32_t));
+            group->columns = calloc((size_t) group->length * group->stride, 1);
+            if (!group->letterMasks || !group->columns) {
+                solverIndexDestroy(index);
+                return false;
+            }
+
+            for (uint32_t i = 0; i < group->count; i++) {
+                const char *word = dictionaryWordString(dict, group->firstWord + i);
+                group->letterMasks[i] = dict->words[group->firstWord + i].letterMask;
+                for (int p = 0; p < group->length; p++) {
+                    group->columns[(size_t) p * group->stride + i] = (uint8_t) word[p];
+                }
+            }
+            if (group->stride > maxStride) maxStride = group->stride;
+            if (group->length <= SOLVER_SHORT_LENGTH && group->count >= SOLVER_TREE_MIN_WORDS &&
+                group->count * (group->length + sizeof(uint32_t)) > maxTreeBytes) {
+                maxTreeBytes = group->count * (group->length + sizeof(uint32_t));
+            }
+        }
+    }
+
+    index->bucketCapacity = SOLVER_LANES;
+    while (index->bucketCapacity < maxStride * 2) index->bucketCapacity <<= 1;
+
+    index->alive = malloc(maxStride);
+    index->live = malloc(maxStride * sizeof(uint32_t));
+    index->familyCounts = calloc((size_t) 1 << SOLVER_SHORT_LENGTH, sizeof(uint32_t));
+    index->families = malloc(((size_t) 1 << SOLVER_SHORT_LENGTH) * sizeof(uint16_t));
+    index->shortPatterns = malloc(maxStride * sizeof(uint16_t));
+    index->patterns = calloc(maxStride, sizeof(PositionMask));
+    index->buckets = calloc(index->bucketCapacity, sizeof(EvilBucket));
+    if (!index->alive || !index->live || !index->familyCounts || !index->families || !index->shortPatterns ||
+        !index->patterns || !index->buckets) {
+        solverIndexDestroy(index);
+        return false;
+    }
+    if (maxTreeBytes == 0) return true;
+
+    //the words of a run are reordered through this scratch, the columns first and the masks after
+    uint8_t *runScratch = malloc(maxTreeBytes);
+    bool built = runScratch != NULL;
+    for (int c = 0; c < index->categoryCount && built; c++) {
+        SolverCategoryIndex *category = &index->categories[c];
+        for (int g = 0; g < category->groupCount && built; g++) {
+            SolverLengthGroup *group = &category->groups[g];
+            if (group->length > SOLVER_SHORT_LENGTH || group->count < SOLVER_TREE_MIN_WORDS) continue;
+
+            group->nodes = malloc(sizeof(SolverHintNode));
+            if (!group->nodes) {
+                built = false;
+                break;
+            }
+            group->nodes[0] = (SolverHintNode) {0, group->count, 0, 0, 0, 0};
+            group->nodeCount = 1;
+
+            char revealed[SOLVER_SHORT_LENGTH + 1];
+            memset(revealed, '_', group->length);
+            revealed[group->length] = '\0';
+            built = splitHintNode(index, group, 0, revealed, 0, runScratch,
+                                  (uint32_t *) (runScratch + (size_t) group->count * group->length));
+        }
+    }
+    free(runScratch);
+    if (!built) {
+        solverIndexDestroy(index);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Frees every group of the index
+ *
+ * @param index SolverIndex struct to release
+ */
+void solverIndexDestroy(SolverIndex *index) {
+    if (index->categories) {
+        for (int c = 0; c < index->categoryCount; c++) {
+            SolverCategoryIndex *category = &index->categories[c];
+            for (int g = 0; g < category->groupCount && category->groups; g++) {
+                free(category->groups[g].letterMasks);
+                free(category->groups[g].columns);
+                free(category->groups[g].nodes);
+            }
+            free(category->groups);
+        }
+    }
+    free(index->categories);
+    free(index->alive);
+    free(index->live);
+    free(index->familyCounts);
+    free(index->families);
+    free(index->shortPatterns);
+    free(index->patterns);
+    free(index->buckets);
+    memset(index, 0, sizeof(*index));
+}
+
+/**
+ * Finds the group of the words of one length in a category
+ *
+ * @return the group, NULL if the category has no word of that length
+ */
+static const SolverLengthGroup *findGroup(const SolverIndex *index, int category, int length) {
+    if (category < 0 || category >= index->categoryCount) return NULL;
+    const SolverCategoryIndex *cat = &index->categories[category];
+    for (int g = 0; g < cat->groupCount; g++) {
+        if (cat->groups[g].length == length) return &cat->groups[g];
+    }
+    return NULL;
+}
+
+/**
+ * Marks the words of a group whose letter set fits, 16 words per step
+ *
+ * @param alive receives 0xFF for every word that has all shown letters and none of the excluded ones
+ * @param start first word, a multiple of SOLVER_LANES
+ * @param end end of the words, a multiple of SOLVER_LANES
+ */
+static void filterLetterMasks(const SolverLengthGroup *group, uint8_t *alive, uint32_t start, uint32_t end,
+                              uint32_t shown, uint32_t excluded) {
+#if SOLVER_SSE2
+    const __m128i shownV = _mm_set1_epi32((int) shown);
+    const __m128i excludedV = _mm_set1_epi32((int) excluded);
+    const __m128i zero = _mm_setzero_si128();
+    for (uint32_t i = start; i < end; i += SOLVER_LANES) {
+        __m128i packed[4];
+        for (int k = 0; k < 4; k++) {
+            __m128i m = _mm_loadu_si128((const __m128i *) (group->letterMasks + i + k * 4));
+            __m128i hasShown = _mm_cmpeq_epi32(_mm_and_si128(m, shownV), shownV);
+            __m128i noExcluded = _mm_cmpeq_epi32(_mm_and_si128(m, excludedV), zero);
+            packed[k] = _mm_and_si128(hasShown, noExcluded);
+        }
+        __m128i low = _mm_packs_epi32(packed[0], packed[1]);
+        __m128i high = _mm_packs_epi32(packed[2], packed[3]);
+        _mm_storeu_si128((__m128i *) (alive + i), _mm_packs_epi16(low, high));
+    }
+#else
+    for (uint32_t i = start; i < end; i++) {
+        uint32_t m = group->letterMasks[i];
+        alive[i] = ((m & shown) == shown && !(m & excluded)) ? 0xFF : 0;
+    }
+#endif
+}
+
+/**
+ * Keeps the words whose character at one position equals c
+ */
+static void filterColumnEquals(const uint8_t *column, uint8_t *alive, uint32_t start, uint32_t end, uint8_t c) {
+#if SOLVER_SSE2
+    const __m128i cV = _mm_set1_epi8((char) c);
+    for (uint32_t i = start; i < end; i += SOLVER_LANES) {
+        __m128i col = _mm_loadu_si128((const __m128i *) (column + i));
+        __m128i a = _mm_loadu_si128((const __m128i *) (alive + i));
+        _mm_storeu_si128((__m128i *) (alive + i), _mm_and_si128(a, _mm_cmpeq_epi8(col, cV)));
+    }
+#else
+    for (uint32_t i = start; i < end; i++) {
+        if (column[i] != c) alive[i] = 0;
+    }
+#endif
+}
+
+/**
+ * Drops the words that have a space or one of the forbidden letters at a hidden position
+ *
+ * @param forbidden lowercase letters that cannot sit behind a blank, at most ALPHABET_SIZE
+ * @param forbiddenCount number of letters in forbidden
+ */
+static void filterColumnHidden(const uint8_t *column, uint8_t *alive, uint32_t start, uint32_t end,
+                               const uint8_t *forbidden, int forbiddenCount) {
+#if SOLVER_SSE2
+    const __m128i space = _mm_set1_epi8(' ');
+    for (uint32_t i = start; i < end; i += SOLVER_LANES) {
+        __m128i col = _mm_loadu_si128((const __m128i *) (column + i));
+        __m128i hit = _mm_cmpeq_epi8(col, space);
+        for (int k = 0; k < forbiddenCount; k++) {
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(col, _mm_set1_epi8((char) forbidden[k])));
+        }
+        __m128i a = _mm_loadu_si128((const __m128i *) (alive + i));
+        _mm_storeu_si128((__m128i *) (alive + i), _mm_andnot_si128(hit, a));
+    }
+#else
+    for (uint32_t i = start; i < end; i++) {
+        bool hit = column[i] == ' ';
+        for (int k = 0; k < forbiddenCount && !hit; k++) hit = column[i] == forbidden[k];
+        if (hit) alive[i] = 0;
+    }
+#endif
+}
+
+/**
+ * Lists the alive words, 16 flags per step
+ *
+ * @param live receives the positions in the group of the alive words
+ * @return number of alive words
+ */
+static uint32_t collectAlive(const uint8_t *alive, uint32_t start, uint32_t end, uint32_t *live) {
+    uint32_t n = 0;
+#if SOLVER_SSE2
+    for (uint32_t i = start; i < end; i += SOLVER_LANES) {
+        uint32_t bits = (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) (alive + i)));
+        for (; bits; bits &= bits - 1) live[n++] = i + (uint32_t) lowestBitIndex64(bits);
+    }
+#else
+    //the flags are random, so the words are collected without a branch that would mispredict half the time
+    for (uint32_t i = start; i < end; i++) {
+        live[n] = i;
+        n += alive[i] & 1;
+    }
+#endif
+    return n;
+}
+
+/**
+ * Counts, per letter, the alive words that contain it
+ * With SSE2 bit k of the masks is added to byte counters for 4 words per step, so no increment waits for another,
+ * and the counters are emptied into letterCounts before they can overflow
+ *
+ * @param letterCounts receives the counts, must be zero
+ * @return number of alive words
+ */
+static uint32_t countLetters(const SolverLengthGroup *group, const uint8_t *alive, uint32_t start, uint32_t end,
+                             uint32_t letterCounts[ALPHABET_SIZE]) {
+    uint32_t aliveCount = 0;
+#if SOLVER_SSE2
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i firstByte = _mm_set1_epi32(1);
+    for (uint32_t chunk = start; chunk < end; chunk += 255 * 4) {
+        uint32_t chunkEnd = end - chunk > 255 * 4 ? chunk + 255 * 4 : end;
+        __m128i counters[8];
+        for (int k = 0; k < 8; k++) counters[k] = _mm_setzero_si128();
+        __m128i aliveCounter = _mm_setzero_si128();
+
+        for (uint32_t i = chunk; i < chunkEnd; i += 4) {
+            int32_t flags;
+            memcpy(&flags, alive + i, sizeof(flags));
+            __m128i wide = _mm_cvtsi32_si128(flags);
+            wide = _mm_unpacklo_epi8(wide, wide);
+            wide = _mm_unpacklo_epi16(wide, wide);
+            aliveCounter = _mm_add_epi8(aliveCounter, _mm_and_si128(wide, firstByte));
+
+            __m128i m = _mm_and_si128(_mm_loadu_si128((const __m128i *) (group->letterMasks + i)), wide);
+            for (int k = 0; k < 8; k++) {
+                counters[k] = _mm_add_epi8(counters[k], _mm_and_si128(m, ones));
+                m = _mm_srli_epi32(m, 1);
+            }
+        }
+
+        //byte b of a mask holds letters 8b to 8b + 7, counter k has bit k of every byte
+        uint8_t bytes[16];
+        for (int k = 0; k < 8; k++) {
+            _mm_storeu_si128((__m128i *) bytes, counters[k]);
+            for (int b = 0; b < 16; b++) {
+                int letter = (b % 4) * 8 + k;
+                if (letter < ALPHABET_SIZE) letterCounts[letter] += bytes[b];
+            }
+        }
+        _mm_storeu_si128((__m128i *) bytes, aliveCounter);
+        for (int b = 0; b < 16; b += 4) aliveCount += bytes[b];
+    }
+#else
+    //histogram each byte of the masks, 4 increments per word instead of one per letter
+    uint32_t histogram[4][256];
+    memset(histogram, 0, sizeof(histogram));
+    for (uint32_t i = start; i < end; i++) {
+        if (!alive[i]) continue;
+
+        uint32_t m = group->letterMasks[i];
+        aliveCount++;
+        histogram[0][m & 0xFF]++;
+        histogram[1][(m >> 8) & 0xFF]++;
+        histogram[2][(m >> 16) & 0xFF]++;
+        histogram[3][m >> 24]++;
+    }
+
+    for (int b = 0; b < 4; b++) {
+        for (int v = 1; v < 256; v++) {
+            if (!histogram[b][v]) continue;
+            for (uint32_t m = (uint32_t) v; m; m &= m - 1) {
+                letterCounts[b * 8 + lowestBitIndex64(m)] += histogram[b][v];
+            }
+        }
+    }
+#endif
+    return aliveCount;
+}
+
+/**
+ * Filters one run of a group down to the words that fit the screen
+ * The candidates are left in index->alive, every other flag in the steps of the run is cleared
+ *
+ * @param first first word of the run
+ * @param end end of the run
+ * @param letterCounts receives, per letter that was not guessed, the number of candidates that contain it
+ * @return number of candidates
+ */
+static uint32_t filterRun(SolverIndex *index, const SolverLengthGroup *group, const char *revealed,
+                          uint32_t guessedSet, uint32_t first, uint32_t end, uint32_t letterCounts[ALPHABET_SIZE]) {
+    memset(letterCounts, 0, ALPHABET_SIZE * sizeof(uint32_t));
+
+    //letters on screen must be in the word, guessed letters that are not on screen must not
+    uint32_t shown = dictionaryLetterMask(revealed, NULL, NULL);
+    uint32_t excluded = guessedSet & ~shown;
+
+    //a guessed letter that is on screen is on screen everywhere it occurs
+    uint8_t forbidden[ALPHABET_SIZE];
+    int forbiddenCount = 0;
+    for (uint32_t m = guessedSet & shown; m; m &= m - 1) {
+        forbidden[forbiddenCount++] = (uint8_t) ('a' + lowestBitIndex64(m));
+    }
+
+    //the filters work on whole steps, the words of the steps outside the run are dropped after
+    uint32_t start = first / SOLVER_LANES * SOLVER_LANES;
+    uint32_t stop = (end + SOLVER_LANES - 1) / SOLVER_LANES * SOLVER_LANES;
+    uint8_t *alive = index->alive;
+    filterLetterMasks(group, alive, start, stop, shown, excluded);
+    for (int p = 0; p < group->length; p++) {
+        const uint8_t *column = group->columns + (size_t) p * group->stride;
+        if (revealed[p] == '_' || revealed[p] == '~') {
+            filterColumnHidden(column, alive, start, stop, forbidden, forbiddenCount);
+        } else {
+            filterColumnEquals(column, alive, start, stop, (uint8_t) revealed[p]);
+        }
+    }
+    memset(alive + start, 0, first - start);
+    memset(alive + end, 0, stop - end);
+
+    uint32_t candidates = countLetters(group, alive, start, stop, letterCounts);
+    for (uint32_t m = guessedSet; m; m &= m - 1) {
+        letterCounts[lowestBitIndex64(m)] = 0;
+    }
+    return candidates;
+}
+
+/**
+ * Follows the hint tree of a group as far as the guessed letters lead
+ * A guessed letter is on screen everywhere it occurs, so its positions pick the child the word is in
+ *
+ * @param exact set to true when exactly the letters on the way to the node were guessed, so its hint applies
+ * @return the node whose run holds every candidate, NULL if the group has no tree
+ */
+static const SolverHintNode *findHintNode(const SolverLengthGroup *group, const char *revealed, uint32_t guessedSet,
+                                          bool *exact) {
+    *exact = false;
+    if (group->nodeCount == 0) return NULL;
+
+    const SolverHintNode *node = &group->nodes[0];
+    uint32_t path = 0;
+    while (node->childCount) {
+        uint32_t bit = 1u << (node->hint - 'a');
+        if (!(guessedSet & bit)) break;
+
+        uint32_t pattern = 0;
+        for (int p = 0; p < group->length; p++) pattern |= (uint32_t) (revealed[p] == node->hint) << p;
+
+        //no child means no word of the run has the letter there, the run is kept and filters down to nothing
+        const SolverHintNode *children = &group->nodes[node->firstChild];
+        uint32_t low = 0, high = node->childCount;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (children[mid].pattern < pattern) low = mid + 1;
+            else high = mid;
+        }
+        if (low == node->childCount || children[low].pattern != pattern) return node;
+
+        path |= bit;
+        node = &children[low];
+    }
+
+    //letters shown by a power up were not guessed, they narrow the candidates past what the node knows
+    if (node->childCount && guessedSet == path) {
+        *exact = true;
+        for (int p = 0; p < group->length && *exact; p++) {
+            char r = revealed[p];
+            *exact = r == '_' || r == '~' || (r >= 'a' && r <= 'z' && ((path >> (r - 'a')) & 1));
+        }
+    }
+    return node;
+}
+
+/**
+ * Same result as solverCountCandidates(), but filters the precomputed columns instead of the strings
+ * The candidates are left in index->alive, flagged at their positions in the group of the word's length
+ *
+ * @param index index built by solverIndexBuild()
+ * @param game GameState struct that contains the current state of the game
+ * @param category index of the category the word came from
+ * @param letterCounts receives, per letter, the number of candidates that contain it
+ * @return number of candidates
+ */
+int solverIndexCountCandidates(SolverIndex *index, const GameState *game, int category,
+                               uint32_t letterCounts[ALPHABET_SIZE]) {
+    memset(letterCounts, 0, ALPHABET_SIZE * sizeof(uint32_t));
+    const SolverLengthGroup *group = findGroup(index, category, (int) strlen(game->revealed));
+    if (!group) return 0;
+
+    bool exact;
+    const SolverHintNode *node = findHintNode(group, game->revealed, game->guessedSet, &exact);
+    uint32_t first = node ? node->first : 0;
+    uint32_t end = node ? node->first + node->count : group->count;
+    return (int) filterRun(index, group, game->revealed, game->guessedSet, first, end, letterCounts);
+}
+
+/**
+ * Sets bit p in the pattern of every alive word that has c at position p
+ */
+static void markColumnPositions(const uint8_t *column, const uint8_t *alive, uint32_t start, uint32_t end, uint8_t c,
+                                int p, PositionMask *patterns) {
+    const uint64_t bit = 1ull << (p % 64);
+#if SOLVER_SSE2
+    const __m128i cV = _mm_set1_epi8((char) c);
+    for (uint32_t i = start; i < end; i += SOLVER_LANES) {
+        __m128i col = _mm_loadu_si128((const __m128i *) (column + i));
+        __m128i a = _mm_loadu_si128((const __m128i *) (alive + i));
+        for (uint32_t hits = (uint32_t) _mm_movemask_epi8(_mm_and_si128(a, _mm_cmpeq_epi8(col, cV))); hits;
+             hits &= hits - 1) {
+            patterns[i + lowestBitIndex64(hits)].bits[p / 64] |= bit;
+        }
+    }
+#else
+    for (uint32_t i = start; i < end; i++) {
+        if (alive[i] && column[i] == c) patterns[i].bits[p / 64] |= bit;
+    }
+#endif
+}
+
+/**
+ * Where c sits in one word of a short group, bit p is set when character p is c
+ */
+static uint32_t shortPattern(const SolverLengthGroup *group, uint32_t i, uint8_t c) {
+    uint32_t pattern = 0;
+    for (int p = 0; p < group->length; p++) {
+        pattern |= (uint32_t) (group->columns[(size_t) p * group->stride + i] == c) << p;
+    }
+    return pattern;
+}
+
+/**
+ * Counts one word into the family of its pattern
+ *
+ * @return the size of the family before the word, adding one to a family of n grows the sum of squares by 2n + 1
+ */
+static inline uint32_t addToFamily(SolverIndex *index, uint32_t pattern, uint32_t *familyCount) {
+    uint32_t size = index->familyCounts[pattern]++;
+    if (size == 0) index->families[(*familyCount)++] = (uint16_t) pattern;
+    return size;
+}
+
+/**
+ * Counts the families of c over every alive word in the steps, 16 words per step
+ * The words without c are skipped, they would all hit the same counter one after another
+ *
+ * @param present sum of squares of the families counted so far
+ * @param bound counting stops once present goes past it
+ * @return false if counting stopped
+ */
+static bool countShortFamilies(SolverIndex *index, const SolverLengthGroup *group, uint32_t start, uint32_t end,
+                               uint8_t c, uint64_t *present, uint64_t bound, uint32_t *familyCount) {
+    for (uint32_t i = start; i < end; i += SOLVER_LANES) {
+        uint16_t patterns[SOLVER_LANES];
+        uint32_t bits = 0;
+#if SOLVER_SSE2
+        //positions 0 to 7 go to the low byte of the pattern, 8 to 15 to the high byte
+        const __m128i cV = _mm_set1_epi8((char) c);
+        __m128i low = _mm_setzero_si128();
+        __m128i high = _mm_setzero_si128();
+        for (int p = 0; p < group->length; p++) {
+            __m128i col = _mm_loadu_si128((const __m128i *) (group->columns + (size_t) p * group->stride + i));
+            __m128i bit = _mm_and_si128(_mm_cmpeq_epi8(col, cV), _mm_set1_epi8((char) (1 << (p % 8))));
+            if (p < 8) low = _mm_or_si128(low, bit);
+            else high = _mm_or_si128(high, bit);
+        }
+        __m128i a = _mm_loadu_si128((const __m128i *) (index->alive + i));
+        low = _mm_and_si128(low, a);
+        high = _mm_and_si128(high, a);
+        bits = ~(uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(low, high), _mm_setzero_si128())) & 0xFFFF;
+        if (!bits) continue;
+        _mm_storeu_si128((__m128i *) patterns, _mm_unpacklo_epi8(low, high));
+        _mm_storeu_si128((__m128i *) (patterns + 8), _mm_unpackhi_epi8(low, high));
+#else
+        for (uint32_t k = 0; k < SOLVER_LANES; k++) {
+            patterns[k] = index->alive[i + k] ? (uint16_t) shortPattern(group, i + k, c) : 0;
+            if (patterns[k]) bits |= 1u << k;
+        }
+#endif
+        for (; bits; bits &= bits - 1) {
+            *present += 2 * (uint64_t) addToFamily(index, patterns[lowestBitIndex64(bits)], familyCount) + 1;
+        }
+        if (*present > bound) return false;
+    }
+    return true;
+}
+
+/**
+ * Splits the candidates of a short word group into families by where c sits
+ * The positions fit an integer, so the families are counted in a direct table
+ *
+ * @param start first step of the run that was filtered
+ * @param end end of the steps of the run that was filtered
+ * @param live the candidates, NULL to score every alive word in the steps instead
+ * @param absent number of candidates without c
+ * @param bestSquares sum of the best letter so far, counting stops once c cannot get below it
+ * @param largest receives the size of the largest family
+ * @return sum of the squared family sizes, UINT64_MAX if counting stopped
+ */
+static uint64_t scoreShortLetter(SolverIndex *index, const SolverLengthGroup *group, uint32_t start, uint32_t end,
+                                 const uint32_t *live, uint32_t liveCount, uint32_t absent, uint64_t bestSquares,
+                                 uint8_t c, uint32_t *largest) {
+    //the family without c is known, the others only add to the sum so they can stop it early
+    uint64_t absentSquare = (uint64_t) absent * absent;
+    uint64_t bound = bestSquares - absentSquare;
+    uint64_t present = 0;
+    uint32_t familyCount = 0;
+    bool counted = true;
+    if (!live) {
+        counted = countShortFamilies(index, group, start, end, c, &present, bound, &familyCount);
+    } else {
+        for (uint32_t k = 0; k < liveCount && counted; k++) {
+            uint32_t pattern = shortPattern(group, live[k], c);
+            if (pattern) present += 2 * (uint64_t) addToFamily(index, pattern, &familyCount) + 1;
+            counted = present <= bound;
+        }
+    }
+
+    *largest = absent;
+    for (uint32_t f = 0; f < familyCount; f++) {
+        uint32_t size = index->familyCounts[index->families[f]];
+        index->familyCounts[index->families[f]] = 0;
+        if (size > *largest) *largest = size;
+    }
+    return counted ? absentSquare + present : UINT64_MAX;
+}
+
+/**
+ * Splits the candidates of any group into families by where c sits, keyed by a PositionMask in a hash table
+ *
+ * @param start first step of the run that was filtered
+ * @param end end of the steps of the run that was filtered
+ * @param absent number of candidates without c
+ * @param largest receives the size of the largest family
+ * @return sum of the squared family sizes
+ */
+static uint64_t scoreLongLetter(SolverIndex *index, const SolverLengthGroup *group, const char *revealed,
+                                uint32_t start, uint32_t end, uint32_t liveCount, uint32_t absent, uint8_t c,
+                                uint32_t *largest) {
+    for (int p = 0; p < group->length; p++) {
+        if (revealed[p] != '_' && revealed[p] != '~') continue;
+        markColumnPositions(group->columns + (size_t) p * group->stride, index->alive, start, end, c, p,
+                            index->patterns);
+    }
+
+    uint32_t capacity = SOLVER_LANES;
+    while (capacity < (liveCount - absent) * 2 && capacity < index->bucketCapacity) capacity <<= 1;
+    uint32_t tableMask = capacity - 1;
+    if (++index->stamp == 0) {
+        memset(index->buckets, 0, index->bucketCapacity * sizeof(EvilBucket));
+        index->stamp = 1;
+    }
+
+    *largest = absent;
+    uint64_t squares = (uint64_t) absent * absent;
+    uint32_t bit = 1u << (c - 'a');
+    for (uint32_t k = 0; k < liveCount; k++) {
+        uint32_t i = index->live[k];
+        if (!(group->letterMasks[i] & bit)) continue;
+
+        PositionMask *key = &index->patterns[i];
+        uint32_t h = hashPositionMask(key) & tableMask;
+        for (;;) {
+            EvilBucket *bucket = &index->buckets[h];
+            if (bucket->stamp != index->stamp) {
+                bucket->stamp = index->stamp;
+                bucket->key = *key;
+                bucket->count = 0;
+                break;
+            }
+            if (positionMaskEquals(&bucket->key, key)) break;
+            h = (h + 1) & tableMask;
+        }
+        memset(key, 0, sizeof(*key));
+
+        uint32_t familySize = ++index->buckets[h].count;
+        squares += 2 * (uint64_t) familySize - 1;
+        if (familySize > *largest) *largest = familySize;
+    }
+    return squares;
+}
+
+/**
+ * Picks the letter expected to leave the fewest of the candidates in one run of a group
+ * A guess shows every position of its letter, so the candidates fall into families by those positions,
+ * the word is in a family with probability size / n, so the expected family is sum(size^2) / n
+ * and the letter with the smallest sum is picked
+ * Ties go to the letter with the smaller largest family, then to the more common letter
+ *
+ * @param candidates receives the number of candidates
+ * @return the letter, 0 if no candidate has a letter that was not guessed
+ */
+static char hintInRun(SolverIndex *index, const SolverLengthGroup *group, const char *revealed, uint32_t guessedSet,
+                      uint32_t first, uint32_t end, uint32_t *candidates) {
+    uint32_t letterCounts[ALPHABET_SIZE];
+    *candidates = filterRun(index, group, revealed, guessedSet, first, end, letterCounts);
+    if (*candidates == 0) return 0;
+
+    //scoring every word of the run is a few instructions per 16 words, a gather per candidate costs more
+    //once more than a quarter of the run is left
+    uint32_t start = first / SOLVER_LANES * SOLVER_LANES;
+    uint32_t stop = (end + SOLVER_LANES - 1) / SOLVER_LANES * SOLVER_LANES;
+    const uint32_t *live = NULL;
+    if (group->length > SOLVER_SHORT_LENGTH || (uint64_t) *candidates * 4 < stop - start) {
+        collectAlive(index->alive, start, stop, index->live);
+        live = index->live;
+    }
+
+    //ranks in the frequency order, sorted so the letters in the most candidates come first
+    int ranks[ALPHABET_SIZE];
+    int rankCount = 0;
+    for (int r = 0; g_letterFrequencyOrder[r] != '\0'; r++) {
+        uint32_t count = letterCounts[g_letterFrequencyOrder[r] - 'a'];
+        if (count == 0) continue;
+
+        int at = rankCount++;
+        while (at > 0 && letterCounts[g_letterFrequencyOrder[ranks[at - 1]] - 'a'] < count) {
+            ranks[at] = ranks[at - 1];
+            at--;
+        }
+        ranks[at] = r;
+    }
+
+    int bestRank = -1;
+    uint32_t bestLargest = 0;
+    uint64_t bestSquares = UINT64_MAX;
+    for (int l = 0; l < rankCount; l++) {
+        char c = g_letterFrequencyOrder[ranks[l]];
+        uint32_t absent = *candidates - letterCounts[c - 'a'];
+
+        //the words without the letter are one family, and the later letters miss even more words,
+        //so once that family alone reaches the best sum no letter left can win
+        if (bestRank >= 0 && (uint64_t) absent * absent >= bestSquares) break;
+
+        uint32_t largest;
+        uint64_t squares;
+        if (group->length <= SOLVER_SHORT_LENGTH) {
+            squares = scoreShortLetter(index, group, start, stop, live, *candidates, absent, bestSquares, (uint8_t) c,
+                                       &largest);
+        } else {
+            squares = scoreLongLetter(index, group, revealed, start, stop, *candidates, absent, (uint8_t) c, &largest);
+        }
+        if (squares == UINT64_MAX) continue;
+
+        if (bestRank < 0 || squares < bestSquares ||
+            (squares == bestSquares && (largest < bestLargest || (largest == bestLargest && ranks[l] < bestRank)))) {
+            bestRank = ranks[l];
+            bestLargest = largest;
+            bestSquares = squares;
+        }
+    }
+
+    return bestRank >= 0 ? g_letterFrequencyOrder[bestRank] : 0;
+}
+
+static int compareFamilies(const void *a, const void *b) {
+    return (int) *(const uint16_t *) a - (int) *(const uint16_t *) b;
+}
+
+/**
+ * Copies word i of a group to slot j of a run laid out like the group, count words per column
+ */
+static void copyRunWord(const SolverLengthGroup *group, uint32_t i, uint8_t *runColumns, uint32_t *runMasks,
+                        uint32_t count, uint32_t j) {
+    runMasks[j] = group->letterMasks[i];
+    for (int p = 0; p < group->length; p++) {
+        runColumns[(size_t) p * count + j] = group->columns[(size_t) p * group->stride + i];
+    }
+}
+
+/**
+ * Finds the hint of a node and, when it still has many candidates, splits its run by where the hint sits
+ * The run is reordered so every family is a child run of its own, sorted by pattern, and the words that
+ * cannot be the word go last, then the large children are split the same way with the hint guessed
+ *
+ * @param revealed the screen on the way to the node, a blank wherever no guessed letter is
+ * @param guessedSet the letters guessed on the way to the node
+ * @param runColumns scratch for the columns of the run, one byte per character of the group
+ * @param runMasks scratch for the letter masks of the run, one per word of the group
+ * @return false if memory ran out
+ */
+static bool splitHintNode(SolverIndex *index, SolverLengthGroup *group, uint32_t nodeIndex, char *revealed,
+                          uint32_t guessedSet, uint8_t *runColumns, uint32_t *runMasks) {
+    uint32_t first = group->nodes[nodeIndex].first;
+    uint32_t count = group->nodes[nodeIndex].count;
+    uint32_t candidates;
+    char hint = hintInRun(index, group, revealed, guessedSet, first, first + count, &candidates);
+    if (!hint || candidates < SOLVER_TREE_MIN_WORDS) return true;
+    collectAlive(index->alive, first / SOLVER_LANES * SOLVER_LANES,
+                 (first + count + SOLVER_LANES - 1) / SOLVER_LANES * SOLVER_LANES, index->live);
+
+    uint32_t *cursors = index->familyCounts;
+    uint32_t familyCount = 0;
+    for (uint32_t k = 0; k < candidates; k++) {
+        uint32_t pattern = shortPattern(group, index->live[k], (uint8_t) hint);
+        index->shortPatterns[k] = (uint16_t) pattern;
+        if (cursors[pattern]++ == 0) index->families[familyCount++] = (uint16_t) pattern;
+    }
+    qsort(index->families, familyCount, sizeof(uint16_t), compareFamilies);
+
+    SolverHintNode *nodes = realloc(group->nodes, (group->nodeCount + familyCount) * sizeof(SolverHintNode));
+    if (!nodes) {
+        for (uint32_t f = 0; f < familyCount; f++) cursors[index->families[f]] = 0;
+        return false;
+    }
+    group->nodes = nodes;
+    uint32_t firstChild = group->nodeCount;
+    group->nodeCount += familyCount;
+    nodes[nodeIndex].hint = hint;
+    nodes[nodeIndex].firstChild = firstChild;
+    nodes[nodeIndex].childCount = familyCount;
+
+    //the count of each family becomes the slot of its next word
+    uint32_t slot = 0;
+    for (uint32_t f = 0; f < familyCount; f++) {
+        uint32_t pattern = index->families[f];
+        nodes[firstChild + f] = (SolverHintNode) {first + slot, cursors[pattern], pattern, 0, 0, 0};
+        slot += cursors[pattern];
+        cursors[pattern] = slot - nodes[firstChild + f].count;
+    }
+    for (uint32_t k = 0; k < candidates; k++) {
+        copyRunWord(group, index->live[k], runColumns, runMasks, count, cursors[index->shortPatterns[k]]++);
+    }
+    for (uint32_t i = first; i < first + count; i++) {
+        if (!index->alive[i]) copyRunWord(group, i, runColumns, runMasks, count, slot++);
+    }
+    for (uint32_t f = 0; f < familyCount; f++) cursors[index->families[f]] = 0;
+
+    memcpy(group->letterMasks + first, runMasks, count * sizeof(uint32_t));
+    for (int p = 0; p < group->length; p++) {
+        memcpy(group->columns + (size_t) p * group->stride + first, runColumns + (size_t) p * count, count);
+    }
+
+    uint32_t bit = 1u << (hint - 'a');
+    for (uint32_t f = 0; f < familyCount; f++) {
+        SolverHintNode child = group->nodes[firstChild + f];
+        if (child.count < SOLVER_TREE_MIN_WORDS) continue;
+
+        for (int p = 0; p < group->length; p++) {
+            if ((child.pattern >> p) & 1) revealed[p] = hint;
+        }
+        bool split = splitHintNode(index, group, firstChild + f, revealed, guessedSet | bit, runColumns, runMasks);
+        if (!split) return false;
+        for (int p = 0; p < group->length; p++) {
+            if ((child.pattern >> p) & 1) revealed[p] = '_';
+        }
+    }
+    return true;
+}
+
+/**
+ * Suggests the letter that is expected to leave the fewest candidates, see hintInRun()
+ * States a fresh game reaches by following every hint in a large group were answered at startup
+ *
+ * @param index index built by solverIndexBuild()
+ * @param game GameState struct that contains the current state of the game
+ * @param category index of the category the word came from
+ * @return suggested letter, letter frequency is used when the word is not in the dictionary
+ */
+char solverIndexSmartHint(SolverIndex *index, const GameState *game, int category) {
+    const SolverLengthGroup *group = findGroup(index, category, (int) strlen(game->revealed));
+    if (!group) return strategyFrequencyGuess(game, NULL, NULL);
+
+    bool exact;
+    const SolverHintNode *node = findHintNode(group, game->revealed, game->guessedSet, &exact);
+    if (exact) return node->hint;
+
+    uint32_t first = node ? node->first : 0;
+    uint32_t end = node ? node->first + node->count : group->count;
+    uint32_t candidates;
+    char hint = hintInRun(index, group, game->revealed, game->guessedSet, first, end, &candidates);
+    return hint ? hint : strategyFrequencyGuess(game, NULL, NULL);
+}
+
+//index of the word corpus, shared by every game for the smart hint power up
+static SolverIndex g_hintIndex;
+
+/**
+ * Builds the smart hint index, call this once at startup after the words are loaded
+ *
+ * @param dict dictionary the games pick their words from
+ * @return true if the index was built
+ */
+bool solverHintInit(const Dictionary *dict) {
+    solverHintDestroy();
+    if (!solverIndexBuild(&g_hintIndex, dict)) {
+        printf("[ERROR] Failed to build smart hint index\n");
+        return false;
+    }
+    return true;
+}
+
+void solverHintDestroy(void) {
+    solverIndexDestroy(&g_hintIndex);
+}
+
+/**
+ * Suggests the letter expected to leave the fewest candidates, the category is found through the hint text
+ *
+ * @param game GameState struct that contains the current state of the game
+ * @return suggested letter
+ */
+char solverSmartHint(const GameState *game) {
+    if (!g_hintIndex.dict) return strategyFrequencyGuess(game, NULL, NULL);
+    return solverIndexSmartHint(&g_hintIndex, game, dictionaryFindCategory(g_hintIndex.dict, game->wordFile));
+}
@@ -0,0 +1,102 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdint.h>
+
+#include "hangman.h"
+#include "../utility/dictionary.h"
+#include "../utility/prng.h"
+
+//what a guessing strategy may know besides the visible game state
+typedef struct {
+    const Dictionary *dict;
+    int category;
+} SolverContext;
+
+//returns the next letter to guess, never one that was already guessed
+typedef char (*GuessStrategy)(const GameState *game, const SolverContext *context, Prng *rng);
+
+typedef struct {
+    const char *name;
+    GuessStrategy guess;
+} Strategy;
+
+extern const Strategy g_strategies[];
+extern const int g_strategyCount;
+
+//english letters from most to least common
+extern const char g_letterFrequencyOrder[];
+
+char strategyRandomGuess(const GameState *game, const SolverContext *context, Prng *rng);
+
+char strategyFrequencyGuess(const GameState *game, const SolverContext *context, Prng *rng);
+
+char strategyCandidateGuess(const GameState *game, const SolverContext *context, Prng *rng);
+
+int solverCountCandidates(const GameState *game, const SolverContext *context, uint32_t letterCounts[ALPHABET_SIZE]);
+
+//a state a fresh game reaches by following every smart hint, found at startup for the groups too large to filter
+typedef struct {
+    uint32_t first;       //the words that fit the letters guessed on the way here, reordered into one run
+    uint32_t count;
+    uint32_t pattern;     //bit p is set when character p is the parent's hint
+    uint32_t firstChild;  //children are sorted by pattern and cover the run, the words that cannot fit go last
+    uint32_t childCount;  //0 when the run is small enough to filter on every query
+    char hint;            //the suggestion when exactly the letters on the way here were guessed
+} SolverHintNode;
+
+//words of one category and one length, stored column major so each filter pass reads one position of every word
+typedef struct {
+    int length;
+    uint32_t firstWord;   //global dictionary index of the first word, the words are reordered by the hint tree
+    uint32_t count;
+    uint32_t stride;      //count rounded up to SOLVER_LANES, the padding is never counted
+    uint32_t *letterMasks; //[stride]
+    uint8_t *columns;      //[length * stride], columns[p * stride + i] is character p of word i
+    SolverHintNode *nodes; //hint tree, nodes[0] is a fresh game, none for small groups and long words
+    uint32_t nodeCount;
+} SolverLengthGroup;
+
+typedef struct {
+    SolverLengthGroup *groups; //sorted by length
+    int groupCount;
+} SolverCategoryIndex;
+
+//precomputed per category at startup so the smart hint can answer on the UI thread
+typedef struct {
+    const Dictionary *dict;
+    SolverCategoryIndex *categories;
+    int categoryCount;
+    uint8_t *alive;          //scratch flags, one per word of the largest group
+    uint32_t *live;          //scratch, the words that passed the filters
+    uint32_t *familyCounts;  //scratch, words per short pattern, zero between letters
+    uint16_t *families;      //scratch, the short patterns seen for the scored letter
+    uint16_t *shortPatterns; //scratch, where the scored letter sits in each word of a short group
+    PositionMask *patterns;  //scratch, where the scored letter sits in each word, zero between letters
+    EvilBucket *buckets;     //scratch open addressing table of the families, capacity is a power of two
+    uint32_t bucketCapacity;
+    uint32_t stamp;          //buckets with an older stamp are empty, so the table is never cleared
+} SolverIndex;
+
+#define SOLVER_LANES 16
+//words up to this length keep the positions of a letter in one integer instead of a PositionMask
+#define SOLVER_SHORT_LENGTH 16
+//hint tree nodes with at least this many candidates are split at startup instead of filtered on every query
+#define SOLVER_TREE_MIN_WORDS 4096
+
+bool solverIndexBuild(SolverIndex *index, const Dictionary *dict);
+
+void solverIndexDestroy(SolverIndex *index);
+
+int solverIndexCountCandidates(SolverIndex *index, const GameState *game, int category,
+                               uint32_t letterCounts[ALPHABET_SIZE]);
+
+char solverIndexSmartHint(SolverIndex *index, const GameState *game, int category);
+
+bool solverHintInit(const Dictionary *dict);
+
+void solverHintDestroy(void);
+
+char solverSmartHint(const GameState *game);
+
+#endif
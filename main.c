@@ -6,12 +6,28 @@
 #include "screens/ingame_ui.h"
 #include "screens/loading_screen.h"
 #include "game/hangman.h"
+#include "game/solver.h"
 #include "screens/graphics/texture_manager.h"
+#include "screens/graphics/font_cache.h"
+#include "screens/graphics/glyph_atlas.h"
+#include "screens/graphics/frame_scheduler.h"
+#include "screens/graphics/layer_cache.h"
 #include "utility/utilities.h"
+#include "utility/word_corpus.h"
+#include "utility/asset_pack.h"
+#include "utility/prng.h"
 
 #define SDL_MAIN_HANDLED
 
 int main(int argc, char *argv[]) {
+    //taken before SDL_Init() so the startup time includes bringing up video, the counter works without it
+    Uint64 launchStart = SDL_GetPerformanceCounter();
+
+    //frame pacing options, --no-vsync and --fps-cap <n>
+    FrameSchedulerConfig frameConfig;
+    frameSchedulerDefaultConfig(&frameConfig);
+    frameSchedulerParseArgs(&frameConfig, argc, argv);
+
     //initialise OpenGL attributes in SDL2
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
@@ -27,11 +43,33 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    //one generator for the app, every game gets its own generator seeded from it
+    Prng appRng;
+    prngSeed(&appRng, prngEntropySeed());
+
+    //every resource is read from one mapped pack when it was built, the loose files are the fallback
+    if (assetPackMount(ASSET_PACK_DEFAULT_PATH)) {
+        printf("Mounted asset pack %s\n", ASSET_PACK_DEFAULT_PATH);
+    } else {
+        printf("No asset pack at %s, loading resources from their own files\n", ASSET_PACK_DEFAULT_PATH);
+    }
+
+    //load every word list once so starting a game never touches the disk
+    if (!wordCorpusInit()) {
+        printf("Failed to load word lists\n");
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    //smart hint power up filters this index instead of the word strings, a failure only makes the hint dumber
+    solverHintInit(wordCorpusDictionary());
+
     SDL_Window *window = SDL_CreateWindow("Hangman",
                                           SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720,
                                           SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
     SDL_Renderer *renderer =
-            SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+            SDL_CreateRenderer(window, -1, frameSchedulerRendererFlags(&frameConfig));
 
     //initialise our renderer
     if (!renderer) {
@@ -39,6 +77,9 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    FrameScheduler scheduler;
+    frameSchedulerInit(&scheduler, renderer, &frameConfig);
+
     //initialize our loading screen
     if (!loadingScreenInit(window, renderer)) {
         printf("Loading screen init failed\n");
@@ -46,7 +87,7 @@ int main(int argc, char *argv[]) {
     }
 
     //start async texture loading (on background thread)
-    if (!textureManagerStartAsyncLoad()) {
+    if (!textureManagerStartAsyncLoad(renderer)) {
         printf("Failed to start texture loading\n");
         return 1;
     }
@@ -54,11 +95,17 @@ int main(int argc, char *argv[]) {
     //show loading screen while textures load
     bool loadingComplete = false;
     while (!loadingComplete) {
+        frameSchedulerBeginFrame(&scheduler);
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 loadingScreenDestroy();
                 textureManagerDestroyAll();
+                solverHintDestroy();
+                wordCorpusDestroy();
+                glyphAtlasDestroyAll();
+                fontCacheDestroy();
+                assetPackUnmount();
                 SDL_DestroyRenderer(renderer);
                 SDL_DestroyWindow(window);
                 TTF_Quit();
@@ -70,15 +117,14 @@ int main(int argc, char *argv[]) {
         float progress = textureManagerGetProgress();
         loadingScreenRender(renderer, window, progress);
 
-        //check if surfaces are loaded
+        //once surfaces are decoded, upload a few per frame so the loading screen keeps its frame rate
         if (textureManagerSurfacesLoaded()) {
-            //now convert surfaces to textures on main thread
-            if (textureManagerProcessLoadedSurfaces(renderer)) {
+            if (textureManagerUploadStep(renderer, TEXTURE_UPLOAD_BUDGET_MS)) {
                 loadingComplete = true;
             }
         }
 
-        SDL_Delay(16); // ~60 FPS
+        frameSchedulerEndFrame(&scheduler);
     }
 
     //destroy loading screen
@@ -89,16 +135,18 @@ int main(int argc, char *argv[]) {
     if (!aboutSectionInit(window, renderer)) return 1;
 
     bool shouldQuit = false;
+    bool startupReported = false;
     bool inMenu = true;
     bool inAbout = false;
     bool inGame = false;
 
     GameState game;
 
-    //timing
-    Uint64 lastTime = SDL_GetPerformanceCounter();
-
     while (!shouldQuit) {
+        //static screens sleep until there is input instead of drawing identical frames, the first menu frame never waits
+        bool idle = startupReported && (inMenu || inAbout || (inGame && !ingameUiIsAnimating()));
+        frameSchedulerWaitForEvents(&scheduler, idle);
+
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             //window close
@@ -106,22 +154,24 @@ int main(int argc, char *argv[]) {
                 shouldQuit = true;
             }
 
+            //baked layers are lost with the render targets and drawn again on the next frame
+            layerCacheHandleEvent(&event);
+
             //main menu input handling
             if (inMenu) {
                 MenuAction action =
                         mainMenuHandleEvent(window, renderer, &event);
 
                 if (action == MENU_START) {
-                    char *wordFile = getRandomWordFileName();
-                    char *word = getRandomWordFromFile(wordFile);
+                    int category = wordCorpusRandomCategory(&appRng);
+                    const char *word = wordCorpusRandomWord(category, &appRng);
                     if (!word) {
                         printf("Failed to get word\n");
                         shouldQuit = true;
                         break;
                     }
 
-                    game = initHangman(wordFile, word, 6);
-                    free(word);
+                    game = initHangman(wordCorpusCategoryName(category), word, 6, prngNext(&appRng));
 
                     if (!ingameUiInit(window, renderer, &game)) {
                         printf("Ingame UI failed\n");
@@ -153,10 +203,10 @@ int main(int argc, char *argv[]) {
         }
 
         //time step
-        Uint64 current = SDL_GetPerformanceCounter();
-        float deltaTime =
-                (float) (current - lastTime) / SDL_GetPerformanceFrequency();
-        lastTime = current;
+        float deltaTime = frameSchedulerBeginFrame(&scheduler);
+
+        //swap in textures that match the window after a big resize
+        textureManagerUpdateTier(renderer);
 
         //render
         if (inMenu) {
@@ -175,10 +225,25 @@ int main(int argc, char *argv[]) {
                 inMenu = true;
             }
         }
+
+        //time until the menu takes input, a launch with an empty texture cache against a warm one shows what it saves
+        if (!startupReported) {
+            printf("[TIMING] First interactive frame %.1f ms after launch\n",
+                   (SDL_GetPerformanceCounter() - launchStart) * 1000.0 / SDL_GetPerformanceFrequency());
+            startupReported = true;
+        }
+
+        frameSchedulerEndFrame(&scheduler);
     }
 
     //destroy screens on exit
+    ingameUiDestroy();
     textureManagerDestroyAll();
+    solverHintDestroy();
+    wordCorpusDestroy();
+    glyphAtlasDestroyAll();
+    fontCacheDestroy();
+    assetPackUnmount();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_Quit();
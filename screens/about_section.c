@@ -7,13 +7,22 @@
 #include <string.h>
 
 #include "graphics/texture_manager.h"
+#include "graphics/glyph_atlas.h"
+#include "graphics/asset_source.h"
+
+#define ABOUT_FONT_PATH "resources/font/PixelifySans-SemiBold.ttf"
+
+typedef struct {
+    const char *text; //points into wrappedText
+    float width;
+    bool endsParagraph;
+} AboutLine;
 
 typedef struct {
-    TTF_Font *font;
+    int fontSize;
     char *rawText;
-    SDL_Texture **lines;
-    int *lineWidths;
-    int *lineHeights;
+    char *wrappedText; //copy of rawText where every line end and wrap point became '\0'
+    AboutLine *lines;  //room for one line per character, so wrapping never allocates
     int numLines;
     int winW, winH;
 } AboutSection;
@@ -22,15 +31,16 @@ static AboutSection about;
 
 //load text file
 static char *loadTextFile(const char *path) {
-    FILE *file = fopen(path, "r");
-    if (!file) return NULL;
-    fseek(file, 0, SEEK_END);
-    long len = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    char *buffer = malloc(len + 1);
-    fread(buffer, 1, len, file);
+    size_t size;
+    char *buffer = assetSourceLoadText(path, &size);
+    if (!buffer) return NULL;
+
+    //read in binary, so drop the carriage returns text mode used to
+    size_t len = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (buffer[i] != '\r') buffer[len++] = buffer[i];
+    }
     buffer[len] = '\0';
-    fclose(file);
 
     //remove BOM if present
     char *start = buffer;
@@ -56,93 +66,65 @@ static char *loadTextFile(const char *path) {
     return buffer;
 }
 
-//render text into textures (handles empty lines and resizing)
-static void renderTextures(SDL_Renderer *renderer) {
-    // Free old textures if they exist
-    if (about.lines) {
-        for (int i = 0; i < about.numLines; i++) {
-            if (about.lines[i]) {
-                SDL_DestroyTexture(about.lines[i]);
-            }
-        }
-        free(about.lines);
-        free(about.lineWidths);
-        free(about.lineHeights);
-    }
+static void addLine(const char *text, float scale, GlyphAtlas *atlas, bool endsParagraph) {
+    int w;
+    glyphAtlasMeasure(atlas, text, &w, NULL);
+    about.lines[about.numLines].text = text;
+    about.lines[about.numLines].width = w * scale;
+    about.lines[about.numLines].endsParagraph = endsParagraph;
+    about.numLines++;
+}
 
+//word wrap the text for the current window and font size, only glyph advances are needed so nothing is rasterized
+static void wrapText(SDL_Renderer *renderer) {
+    about.numLines = 0;
     if (!about.rawText) return;
 
-    //count lines by manually scanning for newlines
-    int lineCount = 0;
-    char *p = about.rawText;
-
-    //handle empty string case
-    if (*p == '\0') {
-        lineCount = 0;
-    } else {
-        lineCount = 1;
-        for (; *p; p++) {
-            if (*p == '\n' && *(p + 1) != '\0') {
-                //only count newline if there's content after it
-                lineCount++;
-            }
-        }
-    }
+    GlyphAtlas *atlas = glyphAtlasGet(renderer, ABOUT_FONT_PATH, (float) about.fontSize);
+    if (!atlas) return;
+    float scale = glyphAtlasScale(atlas, (float) about.fontSize);
+    float wrapWidth = (float) (about.winW - 100); // 50px margin each side
 
-    //allocate arrays
-    about.numLines = lineCount;
-    about.lines = malloc(sizeof(SDL_Texture *) * lineCount);
-    about.lineWidths = malloc(sizeof(int) * lineCount);
-    about.lineHeights = malloc(sizeof(int) * lineCount);
-
-    //render each line
-    SDL_Color white = {255, 255, 255, 255};
-    int wrapWidth = about.winW - 100; // 50px margin each side
-    int fontHeight = TTF_FontHeight(about.font);
-
-    char *lineStart = about.rawText;
-    int idx = 0;
-
-    for (char *p = about.rawText; ; p++) {
-        //check if we've reached end of line or end of string
-        if (*p == '\n' || *p == '\0') {
-            //calculate line length
-            int lineLen = p - lineStart;
-
-            SDL_Surface *surf = NULL;
-            if (lineLen == 0) {
-                //empty line, create small surface for spacing
-                surf = SDL_CreateRGBSurface(0, 1, fontHeight, 32, 0, 0, 0, 0);
-                SDL_FillRect(surf, NULL, SDL_MapRGBA(surf->format, 0, 0, 0, 0));
-            } else {
-                //create a null terminated copy of the line
-                char *lineCopy = malloc(lineLen + 1);
-                strncpy(lineCopy, lineStart, lineLen);
-                lineCopy[lineLen] = '\0';
-
-                //render wrapped text
-                surf = TTF_RenderText_Blended_Wrapped(about.font, lineCopy, white, wrapWidth);
-                free(lineCopy);
-            }
+    strcpy(about.wrappedText, about.rawText);
 
-            if (surf) {
-                about.lines[idx] = SDL_CreateTextureFromSurface(renderer, surf);
-                about.lineWidths[idx] = surf->w;
-                about.lineHeights[idx] = surf->h;
-                SDL_FreeSurface(surf);
-            } else {
-                about.lines[idx] = NULL;
-                about.lineWidths[idx] = 0;
-                about.lineHeights[idx] = fontHeight;
-            }
+    char *lineStart = about.wrappedText;
+    char *lastSpace = NULL;
+    float lineW = 0.0f, widthAtSpace = 0.0f;
 
-            idx++;
+    for (char *p = about.wrappedText; ; p++) {
+        char c = *p;
 
-            //ff we reach end of string, break
-            if (*p == '\0') break;
+        //end of a line in the file
+        if (c == '\n' || c == '\0') {
+            *p = '\0';
+            addLine(lineStart, scale, atlas, true);
+            if (c == '\0') break;
 
-            //move to the start of next line
             lineStart = p + 1;
+            lastSpace = NULL;
+            lineW = 0.0f;
+            continue;
+        }
+
+        if (c == '\r') {
+            *p = '\0';
+            continue;
+        }
+
+        if (c == ' ') {
+            lastSpace = p;
+            widthAtSpace = lineW;
+        }
+        lineW += glyphAtlasAdvance(atlas, c) * scale;
+
+        //too wide, break at the last space and carry the rest of the word over
+        if (lineW > wrapWidth && lastSpace) {
+            *lastSpace = '\0';
+            addLine(lineStart, scale, atlas, false);
+
+            lineW -= widthAtSpace + glyphAtlasAdvance(atlas, ' ') * scale;
+            lineStart = lastSpace + 1;
+            lastSpace = NULL;
         }
     }
 }
@@ -154,28 +136,30 @@ bool aboutSectionInit(SDL_Window *window, SDL_Renderer *renderer) {
 
     SDL_GetWindowSize(window, &about.winW, &about.winH);
 
-    about.font = TTF_OpenFont("resources/font/PixelifySans-SemiBold.ttf", 36);
-    if (!about.font) return false;
+    about.fontSize = 36;
+    if (!glyphAtlasGet(renderer, ABOUT_FONT_PATH, (float) about.fontSize)) return false;
 
     about.rawText = loadTextFile("resources/textures/about_section/about.txt");
     if (!about.rawText) return false;
 
-    renderTextures(renderer); // initial rendering
+    size_t textLen = strlen(about.rawText);
+    about.wrappedText = malloc(textLen + 1);
+    about.lines = malloc(sizeof(AboutLine) * (textLen + 1));
+    if (!about.wrappedText || !about.lines) return false;
+
+    wrapText(renderer); // initial layout
     return true;
 }
 
 //destroy about section
 void aboutSectionDestroy() {
-    if (about.lines) {
-        for (int i = 0; i < about.numLines; i++) {
-            if (about.lines[i]) SDL_DestroyTexture(about.lines[i]);
-        }
-        free(about.lines);
-    }
-    if (about.lineWidths) free(about.lineWidths);
-    if (about.lineHeights) free(about.lineHeights);
-    if (about.rawText) free(about.rawText);
-    if (about.font) TTF_CloseFont(about.font);
+    free(about.lines);
+    free(about.wrappedText);
+    free(about.rawText);
+    about.lines = NULL;
+    about.wrappedText = NULL;
+    about.rawText = NULL;
+    about.numLines = 0;
 
     TTF_Quit();
     IMG_Quit();
@@ -195,23 +179,14 @@ void aboutSectionRender(SDL_Renderer *renderer, SDL_Window *window) {
     bool sizeChanged = (about.winW != prevW || about.winH != prevH);
     bool fontChanged = (newFontSize != prevFontSize);
 
-    //if window size changed or font size changed, rebuild fonts/textures
+    //if window size changed or font size changed, wrap again, the glyphs are only scaled
     if (sizeChanged || fontChanged) {
         prevW = about.winW;
         prevH = about.winH;
         prevFontSize = newFontSize;
 
-        //reopen font at new size
-        if (about.font) {
-            TTF_CloseFont(about.font);
-        }
-        about.font = TTF_OpenFont("resources/font/PixelifySans-SemiBold.ttf", newFontSize);
-        if (!about.font) {
-            printf("ERROR: Could not resize font!\n");
-        }
-
-        //rerender wrapped text
-        renderTextures(renderer);
+        about.fontSize = newFontSize;
+        wrapText(renderer);
     }
 
     //draw everything
@@ -220,18 +195,21 @@ void aboutSectionRender(SDL_Renderer *renderer, SDL_Window *window) {
     SDL_Rect fullWin = {0, 0, about.winW, about.winH};
     SDL_RenderCopy(renderer, g_aboutTextures.background, NULL, &fullWin);
 
-    int y = (int) (about.winH * 0.3);
+    GlyphAtlas *atlas = glyphAtlasGet(renderer, ABOUT_FONT_PATH, (float) about.fontSize);
+    if (atlas) {
+        SDL_Color white = {255, 255, 255, 255};
+        float scale = glyphAtlasScale(atlas, (float) about.fontSize);
+        float lineHeight = atlas->lineHeight * scale;
+        float y = about.winH * 0.3f;
 
-    for (int i = 0; i < about.numLines; i++) {
-        if (about.lines[i]) {
-            SDL_Rect r;
-            r.w = about.lineWidths[i];
-            r.h = about.lineHeights[i];
-            r.x = (about.winW - r.w) / 2;
-            r.y = y;
-            SDL_RenderCopy(renderer, about.lines[i], NULL, &r);
+        for (int i = 0; i < about.numLines; i++) {
+            const AboutLine *line = &about.lines[i];
+            if (line->text[0]) {
+                float x = (about.winW - line->width) / 2.0f;
+                glyphAtlasDrawText(renderer, atlas, line->text, x, y, scale, scale, white, NULL, 0.0f);
+            }
+            y += lineHeight + (line->endsParagraph ? 5 : 0);
         }
-        y += about.lineHeights[i] + 5;
     }
 
     SDL_RenderPresent(renderer);
@@ -0,0 +1,406 @@
+#include "anim_stream.h"
+#include <SDL2/SDL_thread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_source.h"
+#include "../../utility/asset_pack.h"
+
+// ============================================================================
+// WORKER THREAD
+// ============================================================================
+
+//true if frame is one of the ringSize frames starting at the wanted one, wrapping around the loop
+static bool inWindow(const AnimStream *stream, int frame) {
+    int distance = (frame - stream->wanted + stream->frameCount) % stream->frameCount;
+    return distance < stream->ringSize;
+}
+
+static int findSlot(const AnimStream *stream, int frame) {
+    for (int i = 0; i < stream->ringSize; i++) {
+        if (stream->slots[i].state != ANIM_SLOT_EMPTY && stream->slots[i].frame == frame) return i;
+    }
+    return -1;
+}
+
+//a slot that holds nothing, or a frame that fell out of the window, is free to be decoded over
+static int findFreeSlot(const AnimStream *stream) {
+    for (int i = 0; i < stream->ringSize; i++) {
+        const AnimSlot *slot = &stream->slots[i];
+        if (slot->state == ANIM_SLOT_EMPTY) return i;
+        if (slot->state != ANIM_SLOT_DECODING && !inWindow(stream, slot->frame)) return i;
+    }
+    return -1;
+}
+
+//decodes a numbered image straight into the slot buffer, the blit converts whatever the file holds to ARGB8888
+static bool decodeImageFrame(const AnimStream *stream, int frame, AnimSlot *slot) {
+    char path[512];
+    snprintf(path, sizeof(path), stream->pathFormat, frame + 1);
+    SDL_Surface *surf = assetSourceLoadImage(path);
+    if (!surf) return false;
+
+    if (slot->tier != TEXTURE_TIER_FULL) {
+        SDL_Surface *scaled = textureTierScaleSurface(surf, slot->tier);
+        SDL_FreeSurface(surf);
+        if (!scaled) return false;
+        surf = scaled;
+    }
+
+    if (!slot->pixels || slot->width != surf->w || slot->height != surf->h) {
+        Uint32 *pixels = realloc(slot->pixels, (size_t) surf->w * surf->h * sizeof(Uint32));
+        if (!pixels) {
+            SDL_FreeSurface(surf);
+            return false;
+        }
+        slot->pixels = pixels;
+        slot->width = surf->w;
+        slot->height = surf->h;
+    }
+
+    SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormatFrom(slot->pixels, slot->width, slot->height, 32,
+                                                          slot->width * (int) sizeof(Uint32), SDL_PIXELFORMAT_ARGB8888);
+    bool ok = dst != NULL;
+    if (ok) {
+        SDL_SetSurfaceBlendMode(surf, SDL_BLENDMODE_NONE);
+        ok = SDL_BlitSurface(surf, NULL, dst, NULL) == 0;
+        SDL_FreeSurface(dst);
+    }
+    SDL_FreeSurface(surf);
+    slot->baseFrame = -1;
+    return ok;
+}
+
+//advances the canvas to frame with one delta when it is the next frame, or replays from the keyframe otherwise
+static bool decodePackedFrame(AnimStream *stream, int frame, AnimSlot *slot) {
+    const AnimFile *anim = &stream->anim;
+    uint32_t tileCount = animFileTileCount(anim);
+    int width = (int) anim->header->width, height = (int) anim->header->height;
+
+    bool ok = true;
+    int baseFrame = -1;
+    memset(stream->canvasDirty, 0, tileCount);
+    if (stream->canvasFrame >= 0 && frame == (stream->canvasFrame + 1) % stream->frameCount) {
+        //the last record of the file turns the last frame back into the first
+        uint32_t record = frame == 0 ? anim->header->frameCount : (uint32_t) frame;
+        ok = animFileApplyFrame(anim, record, stream->canvas, stream->canvasDirty);
+        baseFrame = stream->canvasFrame;
+    } else {
+        for (int record = 0; record <= frame && ok; record++) {
+            ok = animFileApplyFrame(anim, (uint32_t) record, stream->canvas, NULL);
+        }
+    }
+    stream->canvasFrame = ok ? frame : -1;
+    if (!ok) return false;
+
+    const Uint32 *source = stream->canvas;
+    int divisor = textureTierDivisor(slot->tier);
+    if (divisor > 1) {
+        //the tier canvas follows the full one, only the tiles that changed are filtered down again
+        bool rebuild = !stream->tierCanvas || stream->tierCanvasTier != slot->tier || baseFrame < 0 ||
+                       stream->tierCanvasFrame != baseFrame;
+        if (!stream->tierCanvas || stream->tierCanvasTier != slot->tier) {
+            Uint32 *tierCanvas = realloc(stream->tierCanvas, (size_t) (width / divisor) * (height / divisor) * sizeof(Uint32));
+            if (!tierCanvas) return false;
+            stream->tierCanvas = tierCanvas;
+            stream->tierCanvasTier = slot->tier;
+        }
+
+        int tileSize = (int) anim->header->tileSize;
+        for (uint32_t i = 0; i < tileCount; i++) {
+            if (!rebuild && !stream->canvasDirty[i]) continue;
+            SDL_Rect rect = {(int) (i % anim->header->tilesX) * tileSize, (int) (i / anim->header->tilesX) * tileSize,
+                             tileSize, tileSize};
+            textureTierDownsample(stream->canvas, width, height, width, stream->tierCanvas, width / divisor, &rect,
+                                  divisor);
+        }
+        stream->tierCanvasFrame = frame;
+        source = stream->tierCanvas;
+        width /= divisor;
+        height /= divisor;
+    } else {
+        stream->tierCanvasFrame = -1;
+    }
+
+    if (!slot->pixels || slot->width != width || slot->height != height) {
+        Uint32 *pixels = realloc(slot->pixels, (size_t) width * height * sizeof(Uint32));
+        if (!pixels) return false;
+        slot->pixels = pixels;
+        slot->width = width;
+        slot->height = height;
+    }
+    if (!slot->dirtyTiles) {
+        slot->dirtyTiles = malloc(tileCount);
+        if (!slot->dirtyTiles) return false;
+    }
+    memcpy(slot->pixels, source, (size_t) width * height * sizeof(Uint32));
+    memcpy(slot->dirtyTiles, stream->canvasDirty, tileCount);
+    slot->baseFrame = baseFrame;
+    return true;
+}
+
+static bool decodeFrame(AnimStream *stream, int frame, AnimSlot *slot) {
+    return stream->packed ? decodePackedFrame(stream, frame, slot) : decodeImageFrame(stream, frame, slot);
+}
+
+//keeps the window of frames after the wanted one decoded, sleeps once all of them are
+static int animStreamWorker(void *data) {
+    AnimStream *stream = data;
+
+    SDL_LockMutex(stream->lock);
+    while (!stream->quit) {
+        //nearest missing frame first, so the next frame on screen is never queued behind later ones
+        int frame = -1, slotIndex = -1;
+        for (int k = 0; k < stream->ringSize; k++) {
+            int candidate = (stream->wanted + k) % stream->frameCount;
+            if (findSlot(stream, candidate) >= 0) continue;
+            slotIndex = findFreeSlot(stream);
+            if (slotIndex >= 0) frame = candidate;
+            break;
+        }
+        if (frame < 0) {
+            SDL_CondWait(stream->wake, stream->lock);
+            continue;
+        }
+
+        AnimSlot *slot = &stream->slots[slotIndex];
+        slot->frame = frame;
+        slot->tier = stream->tier;
+        slot->state = ANIM_SLOT_DECODING;
+
+        //decode without the lock so the screen can keep uploading the frames that are ready
+        SDL_UnlockMutex(stream->lock);
+        bool ok = decodeFrame(stream, frame, slot);
+        SDL_LockMutex(stream->lock);
+
+        //a failed frame is remembered so a missing file is not read again until it leaves the window
+        slot->state = ok ? ANIM_SLOT_READY : ANIM_SLOT_FAILED;
+    }
+    SDL_UnlockMutex(stream->lock);
+    return 0;
+}
+
+// ============================================================================
+// MAIN THREAD
+// ============================================================================
+
+static bool startWorker(AnimStream *stream, int frameCount) {
+    stream->frameCount = frameCount;
+    stream->ringSize = frameCount < ANIM_STREAM_RING_SIZE ? frameCount : ANIM_STREAM_RING_SIZE;
+    stream->currentFrame = -1;
+    stream->missedFrame = -1;
+    for (int i = 0; i < ANIM_STREAM_RING_SIZE; i++) stream->slots[i].frame = -1;
+
+    stream->lock = SDL_CreateMutex();
+    stream->wake = SDL_CreateCond();
+    if (!stream->lock || !stream->wake) {
+        printf("[ERROR] Failed to create animation stream lock: %s\n", SDL_GetError());
+        animStreamClose(stream);
+        return false;
+    }
+
+    stream->worker = SDL_CreateThread(animStreamWorker, "AnimStream", stream);
+    if (!stream->worker) {
+        printf("[ERROR] Failed to create animation stream thread: %s\n", SDL_GetError());
+        animStreamClose(stream);
+        return false;
+    }
+    return true;
+}
+
+//starts decoding the first frames right away, the first call to animStreamFrame() creates the textures
+bool animStreamOpen(AnimStream *stream, const char *pathFormat, int frameCount) {
+    memset(stream, 0, sizeof(*stream));
+    if (!pathFormat || frameCount <= 0) return false;
+
+    snprintf(stream->pathFormat, sizeof(stream->pathFormat), "%s", pathFormat);
+    return startWorker(stream, frameCount);
+}
+
+//same as animStreamOpen(), for an animation packed by anim_packer, read in place when the asset pack holds it
+bool animStreamOpenPacked(AnimStream *stream, const char *path) {
+    memset(stream, 0, sizeof(*stream));
+    size_t size;
+    const void *data = assetPackGet(path, &size);
+    if (!(data ? animFileOpenMemory(&stream->anim, data, size) : animFileOpen(&stream->anim, path))) return false;
+
+    size_t pixels = (size_t) stream->anim.header->width * stream->anim.header->height;
+    stream->packed = true;
+    stream->canvasFrame = -1;
+    stream->canvas = malloc(pixels * sizeof(Uint32));
+    stream->canvasDirty = malloc(animFileTileCount(&stream->anim));
+    if (!stream->canvas || !stream->canvasDirty) {
+        animStreamClose(stream);
+        return false;
+    }
+    return startWorker(stream, (int) stream->anim.header->frameCount);
+}
+
+//brings the back texture up to the slot by copying the tiles the slot changed and the ones the back texture was
+//still behind on, runs of neighbouring tiles share one lock, then shows it
+static bool patchSlot(AnimStream *stream, const AnimSlot *slot) {
+    const AnimFileHeader *header = stream->anim.header;
+    int tileSize = (int) header->tileSize / textureTierDivisor(slot->tier);
+    SDL_Texture *texture = stream->textures[stream->nextTexture];
+
+    for (int ty = 0; ty < (int) header->tilesY; ty++) {
+        const Uint8 *row = slot->dirtyTiles + ty * header->tilesX;
+        const Uint8 *stale = stream->staleTiles + ty * header->tilesX;
+        for (int tx = 0; tx < (int) header->tilesX; tx++) {
+            if (!row[tx] && !stale[tx]) continue;
+            int first = tx;
+            while (tx < (int) header->tilesX && (row[tx] || stale[tx])) tx++;
+
+            SDL_Rect rect = {first * tileSize, ty * tileSize, (tx - first) * tileSize, tileSize};
+            if (rect.x + rect.w > slot->width) rect.w = slot->width - rect.x;
+            if (rect.y + rect.h > slot->height) rect.h = slot->height - rect.y;
+
+            void *pixels;
+            int pitch;
+            if (SDL_LockTexture(texture, &rect, &pixels, &pitch) != 0) {
+                stream->backInStep = false;
+                return false;
+            }
+            for (int y = 0; y < rect.h; y++) {
+                memcpy((Uint8 *) pixels + (size_t) y * pitch, slot->pixels + (size_t) (rect.y + y) * slot->width + rect.x,
+                       (size_t) rect.w * sizeof(Uint32));
+            }
+            SDL_UnlockTexture(texture);
+            stream->stats.tilesUploaded += tx - first;
+        }
+    }
+    stream->stats.patches++;
+    return true;
+}
+
+//copies a decoded slot into the back streaming texture and shows it, recreating the textures if the frame size changed
+static bool uploadSlot(AnimStream *stream, SDL_Renderer *renderer, const AnimSlot *slot) {
+    if (slot->width != stream->textureW || slot->height != stream->textureH) {
+        stream->backInStep = false;
+        for (int i = 0; i < ANIM_STREAM_TEXTURES; i++) {
+            if (stream->textures[i]) SDL_DestroyTexture(stream->textures[i]);
+            stream->textures[i] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                                    slot->width, slot->height);
+            if (!stream->textures[i]) {
+                printf("[ERROR] Failed to create animation texture: %s\n", SDL_GetError());
+                stream->textureW = stream->textureH = 0;
+                stream->current = NULL;
+                return false;
+            }
+        }
+        stream->textureW = slot->width;
+        stream->textureH = slot->height;
+        stream->current = NULL;
+    }
+
+    //a delta on top of the frame on screen only touches its changed tiles, plus the ones the back texture missed
+    bool delta = slot->baseFrame >= 0 && slot->baseFrame == stream->currentFrame && stream->current;
+    if (delta && !stream->staleTiles) {
+        stream->staleTiles = malloc(animFileTileCount(&stream->anim));
+        if (!stream->staleTiles) delta = false;
+    }
+
+    if (delta && stream->backInStep) {
+        if (!patchSlot(stream, slot)) return false;
+    } else {
+        SDL_Texture *texture = stream->textures[stream->nextTexture];
+        void *pixels;
+        int pitch;
+        if (SDL_LockTexture(texture, NULL, &pixels, &pitch) != 0) return false;
+
+        size_t rowBytes = (size_t) slot->width * sizeof(Uint32);
+        for (int y = 0; y < slot->height; y++) {
+            memcpy((Uint8 *) pixels + (size_t) y * pitch, slot->pixels + (size_t) y * slot->width, rowBytes);
+        }
+        SDL_UnlockTexture(texture);
+        stream->stats.uploads++;
+    }
+
+    //the texture that was on screen becomes the back one, behind by exactly the tiles this delta changed
+    stream->backInStep = delta;
+    if (delta) memcpy(stream->staleTiles, slot->dirtyTiles, animFileTileCount(&stream->anim));
+    stream->current = stream->textures[stream->nextTexture];
+    stream->nextTexture = (stream->nextTexture + 1) % ANIM_STREAM_TEXTURES;
+    return true;
+}
+
+//returns a texture showing frame, or the last frame shown if the worker has not decoded it yet
+SDL_Texture *animStreamFrame(AnimStream *stream, SDL_Renderer *renderer, int frame) {
+    if (!stream->worker || frame < 0) return stream->current;
+    frame %= stream->frameCount;
+    if (frame == stream->currentFrame) return stream->current;
+
+    SDL_LockMutex(stream->lock);
+    if (stream->wanted != frame) {
+        stream->wanted = frame;
+        SDL_CondSignal(stream->wake);
+    }
+
+    int slotIndex = findSlot(stream, frame);
+    if (slotIndex >= 0 && stream->slots[slotIndex].state == ANIM_SLOT_READY &&
+        stream->slots[slotIndex].tier != stream->tier) {
+        //decoded just before a tier change, have it decoded again at the new tier
+        stream->slots[slotIndex].state = ANIM_SLOT_EMPTY;
+        SDL_CondSignal(stream->wake);
+    }
+    bool ready = slotIndex >= 0 && stream->slots[slotIndex].state == ANIM_SLOT_READY;
+    bool failed = slotIndex >= 0 && stream->slots[slotIndex].state == ANIM_SLOT_FAILED;
+    if (!ready && !failed && stream->missedFrame != frame) {
+        //counted once per frame, the screen asks again every render until it arrives
+        stream->stats.misses++;
+        stream->missedFrame = frame;
+    }
+    SDL_UnlockMutex(stream->lock);
+
+    //the copy runs unlocked so the worker can claim its next slot meanwhile, this one stays put: it is READY and
+    //holds the wanted frame, so the worker never picks it, and only this thread changes wanted or the tier
+    if (ready && uploadSlot(stream, renderer, &stream->slots[slotIndex])) stream->currentFrame = frame;
+    return stream->current;
+}
+
+//frames decoded from now on are filtered down to tier, the frame on screen stays until the next one is ready
+void animStreamSetTier(AnimStream *stream, TextureTier tier) {
+    if (!stream->worker) return;
+
+    SDL_LockMutex(stream->lock);
+    if (stream->tier != tier) {
+        stream->tier = tier;
+        for (int i = 0; i < stream->ringSize; i++) {
+            if (stream->slots[i].state != ANIM_SLOT_DECODING) stream->slots[i].state = ANIM_SLOT_EMPTY;
+        }
+        SDL_CondSignal(stream->wake);
+    }
+    SDL_UnlockMutex(stream->lock);
+}
+
+AnimStreamStats animStreamGetStats(const AnimStream *stream) {
+    return stream->stats;
+}
+
+//stops the worker and frees the ring, call before the renderer is destroyed
+void animStreamClose(AnimStream *stream) {
+    if (stream->worker) {
+        SDL_LockMutex(stream->lock);
+        stream->quit = true;
+        SDL_CondSignal(stream->wake);
+        SDL_UnlockMutex(stream->lock);
+        SDL_WaitThread(stream->worker, NULL);
+    }
+    if (stream->wake) SDL_DestroyCond(stream->wake);
+    if (stream->lock) SDL_DestroyMutex(stream->lock);
+
+    for (int i = 0; i < ANIM_STREAM_RING_SIZE; i++) {
+        free(stream->slots[i].pixels);
+        free(stream->slots[i].dirtyTiles);
+    }
+    free(stream->canvas);
+    free(stream->canvasDirty);
+    free(stream->tierCanvas);
+    free(stream->staleTiles);
+    animFileClose(&stream->anim);
+    for (int i = 0; i < ANIM_STREAM_TEXTURES; i++) {
+        if (stream->textures[i]) SDL_DestroyTexture(stream->textures[i]);
+    }
+    memset(stream, 0, sizeof(*stream));
+}
@@ -0,0 +1,89 @@
+#ifndef ANIM_STREAM_H
+#define ANIM_STREAM_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "../../utility/anim_file.h"
+#include "texture_tier.h"
+
+//frames decoded ahead of the one on screen, memory is bounded by this instead of by the clip length
+#define ANIM_STREAM_RING_SIZE 8
+//streaming textures the decoded frames are uploaded into, two so a frame is never written while it is drawn,
+//a delta frame patches the back texture with its own tiles and the ones the back texture is still behind on
+#define ANIM_STREAM_TEXTURES 2
+
+typedef enum {
+    ANIM_SLOT_EMPTY,
+    ANIM_SLOT_DECODING,
+    ANIM_SLOT_READY,
+    ANIM_SLOT_FAILED
+} AnimSlotState;
+
+//one decoded frame waiting in the ring, owned by the worker while DECODING and by whoever holds the lock otherwise
+typedef struct {
+    int frame;
+    AnimSlotState state;
+    Uint32 *pixels; //ARGB8888, width * height
+    int width, height;
+    TextureTier tier;   //tier the frame was decoded at, a frame from before a tier change is decoded again
+    int baseFrame;      //frame the dirty tiles are relative to, -1 when the whole frame has to be uploaded
+    Uint8 *dirtyTiles;  //packed animations only, 1 for every tile that differs from baseFrame
+} AnimSlot;
+
+typedef struct {
+    unsigned long uploads;      //whole frames copied into a texture
+    unsigned long patches;      //frames applied as changed tiles on top of the previous one
+    unsigned long tilesUploaded;
+    unsigned long misses; //frames that were not decoded in time, the previous frame stayed on screen
+} AnimStreamStats;
+
+typedef struct {
+    char pathFormat[256]; //frame i is read from pathFormat with i + 1, unless the animation is packed
+    int frameCount;
+
+    //packed animations are rebuilt from tile deltas on a canvas that only the worker touches
+    bool packed;
+    AnimFile anim;
+    Uint32 *canvas;
+    Uint8 *canvasDirty;
+    int canvasFrame;
+    Uint32 *tierCanvas; //canvas at tierCanvasTier, updated tile by tile, NULL at the full tier
+    TextureTier tierCanvasTier;
+    int tierCanvasFrame;
+    int ringSize;
+
+    SDL_Thread *worker;
+    SDL_mutex *lock;
+    SDL_cond *wake;
+    bool quit;
+    int wanted; //frame the screen asked for last, the worker decodes the ring ahead of it
+    TextureTier tier;
+
+    AnimSlot slots[ANIM_STREAM_RING_SIZE];
+
+    //main thread only
+    SDL_Texture *textures[ANIM_STREAM_TEXTURES];
+    int textureW, textureH;
+    int nextTexture;
+    SDL_Texture *current;
+    int currentFrame;
+    Uint8 *staleTiles; //packed animations only, 1 for every tile where the back texture differs from current
+    bool backInStep;   //the back texture matches current outside staleTiles, so a delta can be patched onto it
+    int missedFrame;
+    AnimStreamStats stats;
+} AnimStream;
+
+bool animStreamOpen(AnimStream *stream, const char *pathFormat, int frameCount);
+
+bool animStreamOpenPacked(AnimStream *stream, const char *path);
+
+void animStreamSetTier(AnimStream *stream, TextureTier tier);
+
+SDL_Texture *animStreamFrame(AnimStream *stream, SDL_Renderer *renderer, int frame);
+
+AnimStreamStats animStreamGetStats(const AnimStream *stream);
+
+void animStreamClose(AnimStream *stream);
+
+#endif
@@ -0,0 +1,43 @@
+#include "asset_source.h"
+#include <SDL2/SDL_image.h>
+#include <stdlib.h>
+
+#include "../../utility/asset_pack.h"
+
+SDL_RWops *assetSourceOpen(const char *path) {
+    size_t size;
+    const void *data = assetPackGet(path, &size);
+    //a packed asset is a view into the mapping, opening it costs no system call
+    if (data) return SDL_RWFromConstMem(data, (int) size);
+    return SDL_RWFromFile(path, "rb");
+}
+
+SDL_Surface *assetSourceLoadImage(const char *path) {
+    return IMG_Load_RW(assetSourceOpen(path), 1);
+}
+
+SDL_Texture *assetSourceLoadTexture(SDL_Renderer *renderer, const char *path) {
+    return IMG_LoadTexture_RW(renderer, assetSourceOpen(path), 1);
+}
+
+TTF_Font *assetSourceOpenFont(const char *path, int size) {
+    return TTF_OpenFontRW(assetSourceOpen(path), 1, size);
+}
+
+char *assetSourceLoadText(const char *path, size_t *length) {
+    SDL_RWops *rw = assetSourceOpen(path);
+    if (!rw) return NULL;
+
+    Sint64 size = SDL_RWsize(rw);
+    char *text = size >= 0 ? malloc((size_t) size + 1) : NULL;
+    if (!text || SDL_RWread(rw, text, 1, (size_t) size) != (size_t) size) {
+        free(text);
+        SDL_RWclose(rw);
+        return NULL;
+    }
+    SDL_RWclose(rw);
+
+    text[size] = '\0';
+    if (length) *length = (size_t) size;
+    return text;
+}
@@ -0,0 +1,21 @@
+#ifndef ASSET_SOURCE_H
+#define ASSET_SOURCE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+//every resource is asked for by its path, it is read from the mounted asset pack when the pack holds it
+//and from that file otherwise, so the game still runs from loose files without a pack
+SDL_RWops *assetSourceOpen(const char *path);
+
+SDL_Surface *assetSourceLoadImage(const char *path);
+
+SDL_Texture *assetSourceLoadTexture(SDL_Renderer *renderer, const char *path);
+
+//the font keeps reading from its source, packed fonts read straight from the mapping
+TTF_Font *assetSourceOpenFont(const char *path, int size);
+
+//whole file as a null terminated string, free it with free()
+char *assetSourceLoadText(const char *path, size_t *length);
+
+#endif
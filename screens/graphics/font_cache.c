@@ -0,0 +1,77 @@
+#include "font_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "asset_source.h"
+
+typedef struct {
+    char path[256];
+    int size;
+    TTF_Font *font;
+    unsigned long lastUse;
+} FontCacheEntry;
+
+//few faces and sizes are alive at once, so a linear scan beats any hashing
+static struct {
+    FontCacheEntry entries[FONT_CACHE_CAPACITY];
+    unsigned long clock;
+    FontCacheStats stats;
+} g_fontCache = {0};
+
+// ============================================================================
+// LOOKUP
+// ============================================================================
+
+TTF_Font *fontCacheGet(const char *path, int size) {
+    if (!path) return NULL;
+    if (size < 1) size = 1;
+
+    FontCacheEntry *slot = NULL;
+    for (int i = 0; i < FONT_CACHE_CAPACITY; i++) {
+        FontCacheEntry *entry = &g_fontCache.entries[i];
+        if (entry->font && entry->size == size && strcmp(entry->path, path) == 0) {
+            entry->lastUse = ++g_fontCache.clock;
+            g_fontCache.stats.hits++;
+            return entry->font;
+        }
+
+        //remember an empty slot, or else the least recently used one
+        if (!slot || (slot->font && (!entry->font || entry->lastUse < slot->lastUse))) slot = entry;
+    }
+
+    g_fontCache.stats.misses++;
+    TTF_Font *font = assetSourceOpenFont(path, size);
+    if (!font) {
+        printf("[ERROR] Failed to open font %s at size %d: %s\n", path, size, TTF_GetError());
+        return NULL;
+    }
+
+    if (slot->font) {
+        TTF_CloseFont(slot->font);
+        g_fontCache.stats.evictions++;
+        g_fontCache.stats.openFonts--;
+    }
+
+    snprintf(slot->path, sizeof(slot->path), "%s", path);
+    slot->size = size;
+    slot->font = font;
+    slot->lastUse = ++g_fontCache.clock;
+    g_fontCache.stats.openFonts++;
+    return font;
+}
+
+FontCacheStats fontCacheGetStats(void) {
+    return g_fontCache.stats;
+}
+
+// ============================================================================
+// CLEANUP
+// ============================================================================
+
+//close every cached font, call before TTF_Quit
+void fontCacheDestroy(void) {
+    for (int i = 0; i < FONT_CACHE_CAPACITY; i++) {
+        if (g_fontCache.entries[i].font) TTF_CloseFont(g_fontCache.entries[i].font);
+    }
+    memset(&g_fontCache, 0, sizeof(g_fontCache));
+}
@@ -0,0 +1,24 @@
+#ifndef FONT_CACHE_H
+#define FONT_CACHE_H
+
+#include <SDL2/SDL_ttf.h>
+#include <stdbool.h>
+
+#define FONT_CACHE_CAPACITY 16
+
+typedef struct {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    int openFonts;
+} FontCacheStats;
+
+//fonts are owned by the cache, never close them
+//a font stays open until FONT_CACHE_CAPACITY other fonts were requested after it, so do not keep it across frames
+TTF_Font *fontCacheGet(const char *path, int size);
+
+FontCacheStats fontCacheGetStats(void);
+
+void fontCacheDestroy(void);
+
+#endif
@@ -0,0 +1,101 @@
+#include "frame_scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//SDL_Delay can overshoot by a scheduler tick, so the last stretch before a deadline is spun instead of slept
+#define SPIN_MARGIN_MS 2
+
+void frameSchedulerDefaultConfig(FrameSchedulerConfig *config) {
+    config->vsync = true;
+    config->fpsCap = -1;
+}
+
+//reads --no-vsync and --fps-cap <n> from the command line, returns false if an option was malformed
+bool frameSchedulerParseArgs(FrameSchedulerConfig *config, int argc, char *argv[]) {
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-vsync") == 0) {
+            config->vsync = false;
+        } else if (strcmp(argv[i], "--vsync") == 0) {
+            config->vsync = true;
+        } else if (strcmp(argv[i], "--fps-cap") == 0) {
+            char *end = NULL;
+            long cap = i + 1 < argc ? strtol(argv[i + 1], &end, 10) : -1;
+            if (i + 1 >= argc || *end != '\0' || cap < 0 || cap > 1000) {
+                printf("[WARNING] --fps-cap needs a frame rate between 0 (uncapped) and 1000\n");
+                ok = false;
+                continue;
+            }
+            config->fpsCap = (int) cap;
+            i++;
+        } else {
+            printf("[WARNING] Unknown option: %s\n", argv[i]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+//flags to create the renderer with, vsync is requested here because every SDL2 version honours it
+Uint32 frameSchedulerRendererFlags(const FrameSchedulerConfig *config) {
+    return SDL_RENDERER_ACCELERATED | (config->vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+}
+
+void frameSchedulerInit(FrameScheduler *scheduler, SDL_Renderer *renderer, const FrameSchedulerConfig *config) {
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->config = *config;
+    scheduler->frequency = SDL_GetPerformanceFrequency();
+
+    //the driver is free to ignore the vsync request, so ask the renderer what it got
+    SDL_RendererInfo info;
+    if (renderer && SDL_GetRendererInfo(renderer, &info) == 0) {
+        scheduler->vsyncActive = config->vsync && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+    }
+    if (config->vsync && !scheduler->vsyncActive) {
+        printf("[WARNING] Vsync is not available, pacing frames with a timer\n");
+    }
+
+    int fps = config->fpsCap;
+    if (fps < 0) fps = scheduler->vsyncActive ? 0 : FRAME_SCHEDULER_DEFAULT_FPS;
+    scheduler->period = fps > 0 ? scheduler->frequency / (Uint64) fps : 0;
+
+    scheduler->lastFrame = SDL_GetPerformanceCounter();
+    scheduler->nextDeadline = scheduler->lastFrame + scheduler->period;
+}
+
+//blocks until an event is queued when the screen is idle, so a static screen costs no cpu between inputs
+void frameSchedulerWaitForEvents(FrameScheduler *scheduler, bool idle) {
+    if (!idle) return;
+
+    //a NULL event leaves the event in the queue for the caller's poll loop
+    SDL_WaitEventTimeout(NULL, FRAME_SCHEDULER_IDLE_TIMEOUT_MS);
+
+    //the wait replaced the frame timer, the next deadline starts from now
+    scheduler->nextDeadline = SDL_GetPerformanceCounter() + scheduler->period;
+}
+
+//returns the seconds since the previous frame, clamped to FRAME_SCHEDULER_MAX_DELTA
+float frameSchedulerBeginFrame(FrameScheduler *scheduler) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    float deltaTime = (float) (now - scheduler->lastFrame) / (float) scheduler->frequency;
+    scheduler->lastFrame = now;
+    return deltaTime > FRAME_SCHEDULER_MAX_DELTA ? FRAME_SCHEDULER_MAX_DELTA : deltaTime;
+}
+
+//sleeps out the rest of the frame when capped, vsync alone already blocks inside SDL_RenderPresent
+void frameSchedulerEndFrame(FrameScheduler *scheduler) {
+    if (scheduler->period == 0) return;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now < scheduler->nextDeadline) {
+        Uint64 remainingMs = (scheduler->nextDeadline - now) * 1000 / scheduler->frequency;
+        if (remainingMs > SPIN_MARGIN_MS) SDL_Delay((Uint32) (remainingMs - SPIN_MARGIN_MS));
+        while (SDL_GetPerformanceCounter() < scheduler->nextDeadline) {
+        }
+        scheduler->nextDeadline += scheduler->period;
+    } else {
+        //a frame ran long, start counting again instead of rushing to catch up
+        scheduler->nextDeadline = now + scheduler->period;
+    }
+}
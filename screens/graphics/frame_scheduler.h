@@ -0,0 +1,42 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+//frame rate used when vsync is off or the driver ignored it, and no cap was given
+#define FRAME_SCHEDULER_DEFAULT_FPS 60
+//an idle screen still wakes up this often, so a missed expose event only costs one late frame
+#define FRAME_SCHEDULER_IDLE_TIMEOUT_MS 500
+//longest delta handed to the screens, a long idle wait or a stall must not fast forward animations
+#define FRAME_SCHEDULER_MAX_DELTA 0.25f
+
+typedef struct {
+    bool vsync;
+    int fpsCap; //0 for uncapped, -1 to cap at FRAME_SCHEDULER_DEFAULT_FPS only when vsync is not active
+} FrameSchedulerConfig;
+
+typedef struct {
+    FrameSchedulerConfig config;
+    bool vsyncActive;
+    Uint64 frequency;
+    Uint64 period;       //counter ticks per frame, 0 when uncapped
+    Uint64 nextDeadline; //counter value the current frame should end at
+    Uint64 lastFrame;
+} FrameScheduler;
+
+void frameSchedulerDefaultConfig(FrameSchedulerConfig *config);
+
+bool frameSchedulerParseArgs(FrameSchedulerConfig *config, int argc, char *argv[]);
+
+Uint32 frameSchedulerRendererFlags(const FrameSchedulerConfig *config);
+
+void frameSchedulerInit(FrameScheduler *scheduler, SDL_Renderer *renderer, const FrameSchedulerConfig *config);
+
+void frameSchedulerWaitForEvents(FrameScheduler *scheduler, bool idle);
+
+float frameSchedulerBeginFrame(FrameScheduler *scheduler);
+
+void frameSchedulerEndFrame(FrameScheduler *scheduler);
+
+#endif
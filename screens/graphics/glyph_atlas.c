@@ -0,0 +1,279 @@
+#include "glyph_atlas.h"
+#include <SDL2/SDL_ttf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "font_cache.h"
+
+#define ATLAS_WIDTH 1024
+#define ATLAS_PADDING 1
+
+static struct {
+    GlyphAtlas *entries[GLYPH_ATLAS_CAPACITY];
+    unsigned long clock;
+    unsigned long builds;
+
+    //grow only, so drawing stops allocating once the longest string was seen
+    SDL_Vertex *vertices;
+    int *indices;
+    int quadCapacity;
+} g_glyphAtlases = {0};
+
+// ============================================================================
+// ATLAS BUILDING
+// ============================================================================
+
+static void destroyAtlas(GlyphAtlas *atlas) {
+    if (!atlas) return;
+    if (atlas->texture) SDL_DestroyTexture(atlas->texture);
+    free(atlas);
+}
+
+//rasterize every glyph into one texture, packed left to right in rows
+static GlyphAtlas *buildAtlas(SDL_Renderer *renderer, const char *path, int size) {
+    TTF_Font *font = fontCacheGet(path, size);
+    if (!font) return NULL;
+
+    GlyphAtlas *atlas = calloc(1, sizeof(GlyphAtlas));
+    if (!atlas) return NULL;
+    snprintf(atlas->path, sizeof(atlas->path), "%s", path);
+    atlas->size = size;
+    atlas->lineHeight = TTF_FontHeight(font);
+
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface *glyphSurfs[GLYPH_COUNT] = {0};
+
+    int penX = 0, penY = 0, rowH = 0, widest = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        Uint16 ch = (Uint16) (GLYPH_FIRST + i);
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY, &advance) != 0) advance = 0;
+        atlas->glyphs[i].advance = advance;
+
+        //spaces have nothing to draw, only an advance
+        if (ch == ' ') continue;
+        glyphSurfs[i] = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!glyphSurfs[i]) continue;
+
+        int w = glyphSurfs[i]->w, h = glyphSurfs[i]->h;
+        if (penX + w + ATLAS_PADDING > ATLAS_WIDTH) {
+            penX = 0;
+            penY += rowH + ATLAS_PADDING;
+            rowH = 0;
+        }
+        atlas->glyphs[i].src = (SDL_Rect) {penX, penY, w, h};
+        penX += w + ATLAS_PADDING;
+        if (h > rowH) rowH = h;
+        if (w > widest) widest = w;
+    }
+    atlas->width = widest > ATLAS_WIDTH ? widest : ATLAS_WIDTH;
+    atlas->height = penY + rowH;
+    if (atlas->height < 1) atlas->height = 1;
+
+    SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (sheet) {
+        SDL_FillRect(sheet, NULL, SDL_MapRGBA(sheet->format, 255, 255, 255, 0));
+        for (int i = 0; i < GLYPH_COUNT; i++) {
+            if (!glyphSurfs[i]) continue;
+            //copy alpha as is instead of blending it onto the empty sheet
+            SDL_SetSurfaceBlendMode(glyphSurfs[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dst = atlas->glyphs[i].src;
+            SDL_BlitSurface(glyphSurfs[i], NULL, sheet, &dst);
+        }
+        atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+        SDL_FreeSurface(sheet);
+    }
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        if (glyphSurfs[i]) SDL_FreeSurface(glyphSurfs[i]);
+    }
+
+    if (!atlas->texture) {
+        printf("[ERROR] Failed to build glyph atlas for %s at size %d: %s\n", path, size, SDL_GetError());
+        destroyAtlas(atlas);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    //the padding keeps filtered samples from bleeding into the neighbouring glyph,
+    //glyphAtlasGet() picks the master so the filter never shrinks by 2x or more within the supported range
+    SDL_SetTextureScaleMode(atlas->texture, SDL_ScaleModeLinear);
+
+    atlas->id = ++g_glyphAtlases.builds;
+    return atlas;
+}
+
+// ============================================================================
+// LOOKUP
+// ============================================================================
+
+//smallest master at or above pixelSize, the largest one for anything bigger
+static int masterSize(float pixelSize) {
+    int size = GLYPH_ATLAS_MIN_MASTER_SIZE;
+    for (int i = 1; i < GLYPH_ATLAS_MASTER_COUNT && (float) size < pixelSize; i++) size *= 2;
+    return size;
+}
+
+GlyphAtlas *glyphAtlasGet(SDL_Renderer *renderer, const char *path, float pixelSize) {
+    if (!path) return NULL;
+    int size = masterSize(pixelSize);
+
+    int slot = -1;
+    for (int i = 0; i < GLYPH_ATLAS_CAPACITY; i++) {
+        GlyphAtlas *atlas = g_glyphAtlases.entries[i];
+        if (atlas && atlas->size == size && strcmp(atlas->path, path) == 0) {
+            atlas->lastUse = ++g_glyphAtlases.clock;
+            return atlas;
+        }
+
+        //remember an empty slot, or else the least recently used one
+        GlyphAtlas *current = slot >= 0 ? g_glyphAtlases.entries[slot] : NULL;
+        if (slot < 0 || (current && (!atlas || atlas->lastUse < current->lastUse))) slot = i;
+    }
+
+    GlyphAtlas *atlas = buildAtlas(renderer, path, size);
+    if (!atlas) return NULL;
+
+    destroyAtlas(g_glyphAtlases.entries[slot]);
+    g_glyphAtlases.entries[slot] = atlas;
+    atlas->lastUse = ++g_glyphAtlases.clock;
+    return atlas;
+}
+
+//scale that draws the atlas glyphs as if the font was opened at pixelSize
+float glyphAtlasScale(const GlyphAtlas *atlas, float pixelSize) {
+    return pixelSize / (float) atlas->size;
+}
+
+unsigned long glyphAtlasBuildCount(void) {
+    return g_glyphAtlases.builds;
+}
+
+// ============================================================================
+// TEXT LAYOUT AND DRAWING
+// ============================================================================
+
+static const Glyph *glyphFor(const GlyphAtlas *atlas, char c) {
+    if (c < GLYPH_FIRST || c > GLYPH_LAST) c = '?';
+    return &atlas->glyphs[c - GLYPH_FIRST];
+}
+
+//horizontal advance of one character at the atlas size
+int glyphAtlasAdvance(const GlyphAtlas *atlas, char c) {
+    return glyphFor(atlas, c)->advance;
+}
+
+//size of the text at the atlas size, '\n' starts a new line
+void glyphAtlasMeasure(const GlyphAtlas *atlas, const char *text, int *w, int *h) {
+    int lineW = 0, maxW = 0, lines = 1;
+    for (const char *p = text; *p; p++) {
+        if (*p == '\n') {
+            lines++;
+            lineW = 0;
+            continue;
+        }
+        lineW += glyphFor(atlas, *p)->advance;
+        if (lineW > maxW) maxW = lineW;
+    }
+    if (w) *w = maxW;
+    if (h) *h = lines * atlas->lineHeight;
+}
+
+static bool reserveQuads(int quads) {
+    if (quads <= g_glyphAtlases.quadCapacity) return true;
+
+    int capacity = g_glyphAtlases.quadCapacity ? g_glyphAtlases.quadCapacity : 64;
+    while (capacity < quads) capacity *= 2;
+
+    SDL_Vertex *vertices = realloc(g_glyphAtlases.vertices, (size_t) capacity * 4 * sizeof(SDL_Vertex));
+    if (!vertices) return false;
+    g_glyphAtlases.vertices = vertices;
+
+    int *indices = realloc(g_glyphAtlases.indices, (size_t) capacity * 6 * sizeof(int));
+    if (!indices) return false;
+    g_glyphAtlases.indices = indices;
+
+    //the index pattern never changes, so it is written once per quad slot
+    for (int q = g_glyphAtlases.quadCapacity; q < capacity; q++) {
+        int *idx = &indices[q * 6];
+        idx[0] = q * 4;
+        idx[1] = q * 4 + 1;
+        idx[2] = q * 4 + 2;
+        idx[3] = q * 4 + 2;
+        idx[4] = q * 4 + 3;
+        idx[5] = q * 4;
+    }
+    g_glyphAtlases.quadCapacity = capacity;
+    return true;
+}
+
+//write one quad per visible glyph into vertices, which needs room for strlen(text) quads, returns the quad count
+int glyphAtlasLayout(const GlyphAtlas *atlas, const char *text, float x, float y, float scaleX, float scaleY,
+                     SDL_Color color, SDL_Vertex *vertices) {
+    int quad = 0;
+    float invW = 1.0f / (float) atlas->width;
+    float invH = 1.0f / (float) atlas->height;
+    float penX = x, penY = y;
+
+    for (const char *p = text; *p; p++) {
+        if (*p == '\n') {
+            penX = x;
+            penY += atlas->lineHeight * scaleY;
+            continue;
+        }
+
+        const Glyph *glyph = glyphFor(atlas, *p);
+        if (glyph->src.w > 0) {
+            float x0 = penX, y0 = penY;
+            float x1 = penX + glyph->src.w * scaleX, y1 = penY + glyph->src.h * scaleY;
+            float u0 = glyph->src.x * invW, v0 = glyph->src.y * invH;
+            float u1 = (glyph->src.x + glyph->src.w) * invW, v1 = (glyph->src.y + glyph->src.h) * invH;
+
+            SDL_Vertex *v = &vertices[quad * 4];
+            v[0] = (SDL_Vertex) {{x0, y0}, color, {u0, v0}};
+            v[1] = (SDL_Vertex) {{x1, y0}, color, {u1, v0}};
+            v[2] = (SDL_Vertex) {{x1, y1}, color, {u1, v1}};
+            v[3] = (SDL_Vertex) {{x0, y1}, color, {u0, v1}};
+            quad++;
+        }
+        penX += glyph->advance * scaleX;
+    }
+    return quad;
+}
+
+//shared index buffer for quads laid out by glyphAtlasLayout(), NULL if it could not grow to the given quad count
+const int *glyphAtlasQuadIndices(int quads) {
+    return reserveQuads(quads) ? g_glyphAtlases.indices : NULL;
+}
+
+//draws the text, and its shadow behind it when shadow is given, in a single geometry batch
+void glyphAtlasDrawText(SDL_Renderer *renderer, const GlyphAtlas *atlas, const char *text, float x, float y,
+                        float scaleX, float scaleY, SDL_Color color, const SDL_Color *shadow, float shadowOffset) {
+    if (!atlas || !text || !atlas->texture) return;
+
+    int length = (int) strlen(text);
+    if (!reserveQuads(shadow ? length * 2 : length)) return;
+
+    int quads = 0;
+    if (shadow) {
+        quads = glyphAtlasLayout(atlas, text, x + shadowOffset, y + shadowOffset, scaleX, scaleY, *shadow,
+                                 g_glyphAtlases.vertices);
+    }
+    quads += glyphAtlasLayout(atlas, text, x, y, scaleX, scaleY, color, &g_glyphAtlases.vertices[quads * 4]);
+    if (quads == 0) return;
+
+    SDL_RenderGeometry(renderer, atlas->texture, g_glyphAtlases.vertices, quads * 4, g_glyphAtlases.indices, quads * 6);
+}
+
+// ============================================================================
+// CLEANUP
+// ============================================================================
+
+//destroy every atlas texture, call before the renderer is destroyed
+void glyphAtlasDestroyAll(void) {
+    for (int i = 0; i < GLYPH_ATLAS_CAPACITY; i++) {
+        destroyAtlas(g_glyphAtlases.entries[i]);
+    }
+    free(g_glyphAtlases.vertices);
+    free(g_glyphAtlases.indices);
+    memset(&g_glyphAtlases, 0, sizeof(g_glyphAtlases));
+}
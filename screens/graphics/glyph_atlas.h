@@ -0,0 +1,64 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+//printable ascii, anything else is drawn as '?'
+#define GLYPH_FIRST ' '
+#define GLYPH_LAST '~'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+
+//room for every master size of the three faces the screens use
+#define GLYPH_ATLAS_CAPACITY 12
+
+//a face is rasterized at a few master sizes and text is drawn from the smallest one at or above its size, scaled
+//by the geometry, so text size changes only rasterize when they cross into another master.
+//linear filtering without mipmaps only averages neighbouring texels, so 1 px strokes of a pixel font alias and
+//blur once shrunk by 2x or more. masters a power of two apart keep the shrink below 2x for every size above half
+//the smallest master up to the largest, which is above anything the screens draw (the hud word at about 100,
+//about text up to a 2560 high window). smaller text still shrinks further, larger text is upscaled and soft
+#define GLYPH_ATLAS_MASTER_COUNT 4
+#define GLYPH_ATLAS_MIN_MASTER_SIZE 16
+
+typedef struct {
+    SDL_Rect src; //cell inside the atlas texture, as tall as a line
+    int advance;
+} Glyph;
+
+//every glyph of one face, rasterized once in white at one master size so vertex colours can tint it
+typedef struct {
+    char path[256];
+    int size; //pixel size the glyphs were rasterized at, every metric below is at this size
+    SDL_Texture *texture;
+    int width, height;
+    int lineHeight;
+    Glyph glyphs[GLYPH_COUNT];
+    unsigned long lastUse;
+    unsigned long id; //unique per build, so geometry laid out against an evicted atlas can be detected
+} GlyphAtlas;
+
+//atlas of the master size that suits text drawn at pixelSize, scale it with glyphAtlasScale() for that same size
+//atlases are owned by the cache and stay valid until GLYPH_ATLAS_CAPACITY other atlases were requested
+GlyphAtlas *glyphAtlasGet(SDL_Renderer *renderer, const char *path, float pixelSize);
+
+float glyphAtlasScale(const GlyphAtlas *atlas, float pixelSize);
+
+int glyphAtlasAdvance(const GlyphAtlas *atlas, char c);
+
+void glyphAtlasMeasure(const GlyphAtlas *atlas, const char *text, int *w, int *h);
+
+int glyphAtlasLayout(const GlyphAtlas *atlas, const char *text, float x, float y, float scaleX, float scaleY,
+                     SDL_Color color, SDL_Vertex *vertices);
+
+const int *glyphAtlasQuadIndices(int quads);
+
+void glyphAtlasDrawText(SDL_Renderer *renderer, const GlyphAtlas *atlas, const char *text, float x, float y,
+                        float scaleX, float scaleY, SDL_Color color, const SDL_Color *shadow, float shadowOffset);
+
+//number of atlases rasterized so far, stays constant once every face and master size in use is cached
+unsigned long glyphAtlasBuildCount(void);
+
+void glyphAtlasDestroyAll(void);
+
+#endif
@@ -0,0 +1,96 @@
+#include "hit_mask.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool opaqueAt(const SDL_Surface *surface, int x, int y) {
+    const Uint32 *row = (const Uint32 *) ((const Uint8 *) surface->pixels + (size_t) y * surface->pitch);
+    return (row[x] >> 24) != 0;
+}
+
+bool hitMaskFromSurface(HitMask *mask, SDL_Surface *surface) {
+    memset(mask, 0, sizeof(*mask));
+    if (!surface) return false;
+
+    //ARGB8888 keeps alpha in the top byte whatever the layout of the source was
+    SDL_Surface *argb = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!argb) {
+        printf("[ERROR] Failed to convert surface for hit mask: %s\n", SDL_GetError());
+        return false;
+    }
+    if (SDL_LockSurface(argb) != 0) {
+        SDL_FreeSurface(argb);
+        return false;
+    }
+
+    mask->width = argb->w;
+    mask->height = argb->h;
+
+    int minX = argb->w, minY = argb->h, maxX = -1, maxY = -1;
+    for (int y = 0; y < argb->h; y++) {
+        for (int x = 0; x < argb->w; x++) {
+            if (!opaqueAt(argb, x, y)) continue;
+            if (x < minX) minX = x;
+            if (x > maxX) maxX = x;
+            if (y < minY) minY = y;
+            if (y > maxY) maxY = y;
+        }
+    }
+
+    bool ok = true;
+    if (maxX >= 0) {
+        mask->bounds = (SDL_Rect) {minX, minY, maxX - minX + 1, maxY - minY + 1};
+        mask->stride = (mask->bounds.w + 7) / 8;
+        mask->bits = calloc((size_t) mask->stride * mask->bounds.h, 1);
+        if (mask->bits) {
+            for (int y = 0; y < mask->bounds.h; y++) {
+                Uint8 *row = mask->bits + (size_t) y * mask->stride;
+                for (int x = 0; x < mask->bounds.w; x++) {
+                    if (opaqueAt(argb, minX + x, minY + y)) row[x >> 3] |= (Uint8) (1 << (x & 7));
+                }
+            }
+        } else {
+            printf("[ERROR] Out of memory for hit mask\n");
+            memset(mask, 0, sizeof(*mask));
+            ok = false;
+        }
+    }
+
+    SDL_UnlockSurface(argb);
+    SDL_FreeSurface(argb);
+    return ok;
+}
+
+bool hitMaskTest(const HitMask *mask, int x, int y) {
+    if (!mask->bits) return false;
+
+    x -= mask->bounds.x;
+    y -= mask->bounds.y;
+    if (x < 0 || y < 0 || x >= mask->bounds.w || y >= mask->bounds.h) return false;
+
+    return (mask->bits[(size_t) y * mask->stride + (x >> 3)] >> (x & 7)) & 1;
+}
+
+bool hitMaskTestScaled(const HitMask *mask, int x, int y, int winW, int winH) {
+    if (winW <= 0 || winH <= 0) return false;
+    return hitMaskTest(mask, x * mask->width / winW, y * mask->height / winH);
+}
+
+bool hitMaskCopy(HitMask *dst, const HitMask *src) {
+    *dst = *src;
+    if (!src->bits) return true;
+
+    size_t size = (size_t) src->stride * src->bounds.h;
+    dst->bits = malloc(size);
+    if (!dst->bits) {
+        memset(dst, 0, sizeof(*dst));
+        return false;
+    }
+    memcpy(dst->bits, src->bits, size);
+    return true;
+}
+
+void hitMaskDestroy(HitMask *mask) {
+    free(mask->bits);
+    memset(mask, 0, sizeof(*mask));
+}
@@ -0,0 +1,29 @@
+#ifndef HIT_MASK_H
+#define HIT_MASK_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+//one bit per pixel of a sprite that is clicked pixel perfect, kept instead of the decoded image
+//only the tightest rect around the opaque pixels is stored, a test outside it never touches the bits
+typedef struct {
+    Uint8 *bits;    //row major over bounds, a set bit is an opaque pixel
+    int stride;     //bytes per row of bits
+    SDL_Rect bounds;
+    int width, height; //size of the image the mask was taken from
+} HitMask;
+
+//any pixel format, the surface is not modified and can be freed afterwards
+bool hitMaskFromSurface(HitMask *mask, SDL_Surface *surface);
+
+//x and y are in image pixels
+bool hitMaskTest(const HitMask *mask, int x, int y);
+
+//maps a point of a window the image is stretched over to image pixels first
+bool hitMaskTestScaled(const HitMask *mask, int x, int y, int winW, int winH);
+
+bool hitMaskCopy(HitMask *dst, const HitMask *src);
+
+void hitMaskDestroy(HitMask *mask);
+
+#endif
@@ -0,0 +1,70 @@
+#include "label_map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool labelMapBuild(LabelMap *map, const HitMask *masks, int count) {
+    memset(map, 0, sizeof(*map));
+    if (count > LABEL_MAP_MAX_LABELS) {
+        printf("[ERROR] Label map holds at most %d images, got %d\n", LABEL_MAP_MAX_LABELS, count);
+        return false;
+    }
+
+    int minX = 0, minY = 0, maxX = 0, maxY = 0;
+    bool any = false;
+    for (int i = 0; i < count; i++) {
+        if (masks[i].width > map->width) map->width = masks[i].width;
+        if (masks[i].height > map->height) map->height = masks[i].height;
+        if (!masks[i].bits) continue;
+
+        const SDL_Rect *b = &masks[i].bounds;
+        if (!any || b->x < minX) minX = b->x;
+        if (!any || b->y < minY) minY = b->y;
+        if (!any || b->x + b->w > maxX) maxX = b->x + b->w;
+        if (!any || b->y + b->h > maxY) maxY = b->y + b->h;
+        any = true;
+    }
+    if (!any) return true;
+
+    map->bounds = (SDL_Rect) {minX, minY, maxX - minX, maxY - minY};
+    map->labels = calloc((size_t) map->bounds.w * map->bounds.h, 1);
+    if (!map->labels) {
+        printf("[ERROR] Out of memory for label map\n");
+        memset(map, 0, sizeof(*map));
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const HitMask *mask = &masks[i];
+        if (!mask->bits) continue;
+
+        for (int y = 0; y < mask->bounds.h; y++) {
+            const Uint8 *bits = mask->bits + (size_t) y * mask->stride;
+            Uint8 *row = map->labels + (size_t) (mask->bounds.y - minY + y) * map->bounds.w + (mask->bounds.x - minX);
+            for (int x = 0; x < mask->bounds.w; x++) {
+                if ((bits[x >> 3] >> (x & 7)) & 1) row[x] = (Uint8) (i + 1);
+            }
+        }
+    }
+    return true;
+}
+
+int labelMapLookup(const LabelMap *map, int x, int y) {
+    if (!map->labels) return LABEL_MAP_NONE;
+
+    x -= map->bounds.x;
+    y -= map->bounds.y;
+    if (x < 0 || y < 0 || x >= map->bounds.w || y >= map->bounds.h) return LABEL_MAP_NONE;
+
+    return map->labels[(size_t) y * map->bounds.w + x];
+}
+
+int labelMapLookupScaled(const LabelMap *map, int x, int y, int winW, int winH) {
+    if (winW <= 0 || winH <= 0) return LABEL_MAP_NONE;
+    return labelMapLookup(map, x * map->width / winW, y * map->height / winH);
+}
+
+void labelMapDestroy(LabelMap *map) {
+    free(map->labels);
+    memset(map, 0, sizeof(*map));
+}
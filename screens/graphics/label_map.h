@@ -0,0 +1,31 @@
+#ifndef LABEL_MAP_H
+#define LABEL_MAP_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "hit_mask.h"
+
+#define LABEL_MAP_NONE 0
+#define LABEL_MAP_MAX_LABELS 255
+
+//one byte per pixel naming which of a group of stacked images is under it, so a click is a single lookup
+//covers the union of the bounds of the images, a lookup outside it is LABEL_MAP_NONE straight away
+typedef struct {
+    Uint8 *labels;  //row major over bounds
+    SDL_Rect bounds;
+    int width, height; //size of the images the map was built from
+} LabelMap;
+
+//the label of masks[i] is i + 1, where masks overlap the later one wins like it would on screen
+bool labelMapBuild(LabelMap *map, const HitMask *masks, int count);
+
+//x and y are in image pixels
+int labelMapLookup(const LabelMap *map, int x, int y);
+
+//maps a point of a window the images are stretched over to image pixels first
+int labelMapLookupScaled(const LabelMap *map, int x, int y, int winW, int winH);
+
+void labelMapDestroy(LabelMap *map);
+
+#endif
@@ -0,0 +1,98 @@
+#include "layer_cache.h"
+#include <stdio.h>
+
+static unsigned long g_resetGeneration = 0;
+static unsigned long g_layerBakes = 0;
+
+//blending into a cleared target leaves colour multiplied by alpha, so the layer goes on screen as premultiplied
+static SDL_BlendMode premultipliedBlendMode(void) {
+    return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+}
+
+static void useDirectDrawing(LayerCache *layer, const char *reason) {
+    printf("[WARNING] Layer cache disabled, %s: %s\n", reason, SDL_GetError());
+    layerCacheDestroy(layer);
+    layer->direct = true;
+}
+
+static bool createTarget(LayerCache *layer, SDL_Renderer *renderer, int width, int height) {
+    if (layer->texture) SDL_DestroyTexture(layer->texture);
+    layer->valid = false;
+
+    layer->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!layer->texture) {
+        useDirectDrawing(layer, "render target creation failed");
+        return false;
+    }
+    if (SDL_SetTextureBlendMode(layer->texture, premultipliedBlendMode()) != 0) {
+        useDirectDrawing(layer, "premultiplied blending unsupported");
+        return false;
+    }
+
+    layer->width = width;
+    layer->height = height;
+    return true;
+}
+
+bool layerCacheBegin(LayerCache *layer, SDL_Renderer *renderer, int width, int height, Uint64 key) {
+    if (layer->direct) return true;
+    if (!SDL_RenderTargetSupported(renderer)) {
+        useDirectDrawing(layer, "render targets unsupported");
+        return true;
+    }
+    if (width <= 0 || height <= 0) return false;
+
+    if (!layer->texture || layer->width != width || layer->height != height) {
+        if (!createTarget(layer, renderer, width, height)) return true;
+    }
+
+    if (layer->valid && layer->key == key && layer->resetGeneration == g_resetGeneration) return false;
+
+    //draw this frame straight to the screen and try the target again next frame
+    layer->valid = false;
+    if (SDL_SetRenderTarget(renderer, layer->texture) != 0) return true;
+
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+    layer->key = key;
+    layer->resetGeneration = g_resetGeneration;
+    layer->baking = true;
+    return true;
+}
+
+void layerCacheEnd(LayerCache *layer, SDL_Renderer *renderer, const SDL_Rect *dst) {
+    if (layer->baking) {
+        SDL_SetRenderTarget(renderer, NULL);
+        layer->baking = false;
+        layer->valid = true;
+        g_layerBakes++;
+    }
+
+    if (!layer->direct && layer->valid) SDL_RenderCopy(renderer, layer->texture, NULL, dst);
+}
+
+void layerCacheInvalidate(LayerCache *layer) {
+    layer->valid = false;
+}
+
+void layerCacheDestroy(LayerCache *layer) {
+    if (layer->texture) SDL_DestroyTexture(layer->texture);
+    layer->texture = NULL;
+    layer->width = 0;
+    layer->height = 0;
+    layer->valid = false;
+    layer->baking = false;
+}
+
+void layerCacheHandleEvent(const SDL_Event *event) {
+    if (event->type == SDL_RENDER_TARGETS_RESET || event->type == SDL_RENDER_DEVICE_RESET) g_resetGeneration++;
+}
+
+unsigned long layerCacheBakeCount(void) {
+    return g_layerBakes;
+}
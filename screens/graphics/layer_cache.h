@@ -0,0 +1,36 @@
+#ifndef LAYER_CACHE_H
+#define LAYER_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+//a stack of static full screen images baked into one render target texture
+//the owner describes what is in the layer with a key, the layer is only drawn again when the key or size changes
+typedef struct {
+    SDL_Texture *texture;
+    int width, height;
+    Uint64 key;
+    unsigned long resetGeneration; //render target reset the contents were baked after
+    bool valid;
+    bool baking;
+    bool direct; //render targets or the blend mode are unsupported, layers are drawn straight to the screen
+} LayerCache;
+
+//returns true when the layer has to be drawn, every draw until layerCacheEnd() lands in the layer
+//when it returns false the baked layer is still good and nothing has to be drawn
+bool layerCacheBegin(LayerCache *layer, SDL_Renderer *renderer, int width, int height, Uint64 key);
+
+//stops baking and puts the layer on screen at dst
+void layerCacheEnd(LayerCache *layer, SDL_Renderer *renderer, const SDL_Rect *dst);
+
+void layerCacheInvalidate(LayerCache *layer);
+
+void layerCacheDestroy(LayerCache *layer);
+
+//render target contents are lost on SDL_RENDER_TARGETS_RESET and SDL_RENDER_DEVICE_RESET, pass every event here
+void layerCacheHandleEvent(const SDL_Event *event);
+
+//number of times any layer was baked, a steady frame leaves it unchanged
+unsigned long layerCacheBakeCount(void);
+
+#endif
@@ -0,0 +1,104 @@
+#include "text_object.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned long g_textObjectRebuilds = 0;
+
+static bool sameColor(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static bool keyMatches(const TextObject *object, const GlyphAtlas *atlas, const char *text, float size,
+                       SDL_Color color, const SDL_Color *shadow, float shadowOffset) {
+    if (object->atlasId != atlas->id || object->size != size || !sameColor(object->color, color)) return false;
+    if (object->hasShadow != (shadow != NULL)) return false;
+    if (shadow && (!sameColor(object->shadow, *shadow) || object->shadowOffset != shadowOffset)) return false;
+    //text beyond the buffer is cut off when stored, so it is ignored here too
+    return strncmp(object->text, text, sizeof(object->text) - 1) == 0;
+}
+
+static bool reserveQuads(TextObject *object, int quads) {
+    if (quads <= object->quadCapacity) return true;
+
+    int capacity = object->quadCapacity ? object->quadCapacity : 16;
+    while (capacity < quads) capacity *= 2;
+
+    SDL_Vertex *vertices = realloc(object->vertices, (size_t) capacity * 4 * sizeof(SDL_Vertex));
+    if (!vertices) return false;
+    object->vertices = vertices;
+    object->quadCapacity = capacity;
+    return true;
+}
+
+//point the object at new text, returns true if the geometry had to be rebuilt
+bool textObjectSet(TextObject *object, const GlyphAtlas *atlas, const char *text, float size, SDL_Color color,
+                   const SDL_Color *shadow, float shadowOffset) {
+    if (!object || !atlas || !text) return false;
+    object->atlas = atlas;
+    if (keyMatches(object, atlas, text, size, color, shadow, shadowOffset)) return false;
+
+    snprintf(object->text, sizeof(object->text), "%s", text);
+    object->atlasId = atlas->id;
+    object->size = size;
+    object->color = color;
+    object->hasShadow = shadow != NULL;
+    object->shadow = shadow ? *shadow : (SDL_Color) {0, 0, 0, 0};
+    object->shadowOffset = shadow ? shadowOffset : 0.0f;
+
+    //lay out at the origin, textObjectDraw() moves it into place
+    object->quadCount = 0;
+    object->x = 0.0f;
+    object->y = 0.0f;
+
+    float scale = glyphAtlasScale(atlas, size);
+    int w, h;
+    glyphAtlasMeasure(atlas, object->text, &w, &h);
+    object->width = w * scale;
+    object->height = h * scale;
+
+    int length = (int) strlen(object->text);
+    if (reserveQuads(object, object->hasShadow ? length * 2 : length)) {
+        int quads = 0;
+        if (object->hasShadow) {
+            quads = glyphAtlasLayout(atlas, object->text, shadowOffset, shadowOffset, scale, scale, object->shadow,
+                                     object->vertices);
+        }
+        quads += glyphAtlasLayout(atlas, object->text, 0.0f, 0.0f, scale, scale, color, &object->vertices[quads * 4]);
+        object->quadCount = quads;
+    }
+
+    g_textObjectRebuilds++;
+    return true;
+}
+
+//draws the cached geometry with its top left corner at x, y
+void textObjectDraw(SDL_Renderer *renderer, TextObject *object, float x, float y) {
+    if (!object || !object->atlas || !object->atlas->texture || object->quadCount == 0) return;
+
+    //moving is a shift of the cached vertices, the text is not laid out again
+    if (x != object->x || y != object->y) {
+        float dx = x - object->x, dy = y - object->y;
+        for (int i = 0; i < object->quadCount * 4; i++) {
+            object->vertices[i].position.x += dx;
+            object->vertices[i].position.y += dy;
+        }
+        object->x = x;
+        object->y = y;
+    }
+
+    const int *indices = glyphAtlasQuadIndices(object->quadCount);
+    if (!indices) return;
+    SDL_RenderGeometry(renderer, object->atlas->texture, object->vertices, object->quadCount * 4, indices,
+                       object->quadCount * 6);
+}
+
+void textObjectDestroy(TextObject *object) {
+    if (!object) return;
+    free(object->vertices);
+    memset(object, 0, sizeof(*object));
+}
+
+unsigned long textObjectRebuildCount(void) {
+    return g_textObjectRebuilds;
+}
@@ -0,0 +1,42 @@
+#ifndef TEXT_OBJECT_H
+#define TEXT_OBJECT_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "glyph_atlas.h"
+
+#define TEXT_OBJECT_MAX_LEN 256
+
+//a piece of screen text that keeps its laid out geometry between frames
+//the geometry is only rebuilt when the key (text, face, size, colours) changes, moving it only shifts the vertices
+typedef struct {
+    //key
+    char text[TEXT_OBJECT_MAX_LEN];
+    unsigned long atlasId;
+    float size;
+    SDL_Color color;
+    bool hasShadow;
+    SDL_Color shadow;
+    float shadowOffset;
+
+    //cached geometry, placed at x, y
+    const GlyphAtlas *atlas;
+    SDL_Vertex *vertices;
+    int quadCount;
+    int quadCapacity;
+    float x, y;
+    float width, height; //laid out size in pixels, valid after textObjectSet()
+} TextObject;
+
+bool textObjectSet(TextObject *object, const GlyphAtlas *atlas, const char *text, float size, SDL_Color color,
+                   const SDL_Color *shadow, float shadowOffset);
+
+void textObjectDraw(SDL_Renderer *renderer, TextObject *object, float x, float y);
+
+void textObjectDestroy(TextObject *object);
+
+//number of times any text object rebuilt its geometry, a steady frame leaves it unchanged
+unsigned long textObjectRebuildCount(void);
+
+#endif
@@ -0,0 +1,261 @@
+#include "texture_cache.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "../../utility/asset_pack.h"
+#include "../../utility/mapped_file.h"
+
+// ============================================================================
+// ENTRY FORMAT (native endian, the cache never leaves the machine that wrote it)
+//
+//   TextureCacheHeader
+//   pixels      height rows of pitch bytes in format, at pixelsOffset
+//   mask bits   maskBounds.h rows of maskStride bytes, at maskOffset, only for hit tested images
+// ============================================================================
+
+#define TEXTURE_CACHE_MAGIC "HNGPIXC"
+#define TEXTURE_CACHE_VERSION 1
+#define TEXTURE_CACHE_ALIGNMENT 64
+
+typedef struct {
+    char magic[8];
+    Uint32 version;
+    Uint32 format; //SDL_PixelFormatEnum of the pixels
+    Uint32 tier;
+    Uint32 width, height, pitch;
+    Uint64 pathHash;
+    Uint64 sourceStamp; //content hash of a packed source, modification time of a loose file
+    Uint64 sourceSize;
+    Uint32 pixelsOffset;
+    Uint32 maskOffset;  //0 when the image is not hit tested
+    Uint32 maskStride;
+    Sint32 maskBounds[4];
+    Uint32 maskWidth, maskHeight;
+    Uint32 fileSize;
+} TextureCacheHeader;
+
+static char g_cacheDir[512]; //empty while the cache is off
+
+static Uint32 alignUp(Uint32 value) {
+    return (value + TEXTURE_CACHE_ALIGNMENT - 1) & ~(Uint32) (TEXTURE_CACHE_ALIGNMENT - 1);
+}
+
+//what an entry has to match to still be the image at path, without reading the image
+static bool sourceStamp(const char *path, Uint64 *stamp, Uint64 *size) {
+    size_t packedSize;
+    if (assetPackGet(path, &packedSize)) {
+        *size = packedSize;
+        return assetPackGetHash(path, stamp);
+    }
+
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *stamp = (Uint64) st.st_mtime;
+    *size = (Uint64) st.st_size;
+    return true;
+}
+
+static void entryPath(char *out, size_t outSize, const char *path, TextureTier tier) {
+    snprintf(out, outSize, "%s%016llx_%d.hpix", g_cacheDir,
+             (unsigned long long) assetPackHash(path, strlen(path)), (int) tier);
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+bool textureCacheInit(const char *dir) {
+    g_cacheDir[0] = '\0';
+    if (dir) {
+        size_t len = strlen(dir);
+        bool separator = len > 0 && (dir[len - 1] == '/' || dir[len - 1] == '\\');
+        snprintf(g_cacheDir, sizeof(g_cacheDir), "%s%s", dir, separator ? "" : "/");
+        return true;
+    }
+
+    char *prefPath = SDL_GetPrefPath(TEXTURE_CACHE_APP_NAME, "texture_cache");
+    if (!prefPath) {
+        printf("[WARNING] No texture cache directory, images are decoded every launch: %s\n", SDL_GetError());
+        return false;
+    }
+    snprintf(g_cacheDir, sizeof(g_cacheDir), "%s", prefPath);
+    SDL_free(prefPath);
+    return true;
+}
+
+Uint32 textureCacheNativeFormat(SDL_Renderer *renderer) {
+    SDL_RendererInfo info;
+    if (renderer && SDL_GetRendererInfo(renderer, &info) == 0) {
+        for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+            Uint32 format = info.texture_formats[i];
+            if (!SDL_ISPIXELFORMAT_FOURCC(format) && SDL_BYTESPERPIXEL(format) == 4 && SDL_ISPIXELFORMAT_ALPHA(format)) {
+                return format;
+            }
+        }
+    }
+    return SDL_PIXELFORMAT_ARGB8888;
+}
+
+// ============================================================================
+// LOOKUP
+// ============================================================================
+
+SDL_Surface *textureCacheLoad(const char *path, TextureTier tier, Uint32 format, HitMask *mask) {
+    if (!g_cacheDir[0]) return NULL;
+
+    Uint64 stamp, sourceSize;
+    if (!sourceStamp(path, &stamp, &sourceSize)) return NULL;
+
+    char file[640];
+    entryPath(file, sizeof(file), path, tier);
+    MappedFile *mapping = malloc(sizeof(MappedFile));
+    if (!mapping) return NULL;
+    if (!mappedFileOpen(mapping, file)) {
+        free(mapping);
+        return NULL;
+    }
+
+    const TextureCacheHeader *header = mapping->data;
+    size_t size = mapping->size;
+    int bytesPerPixel = SDL_BYTESPERPIXEL(format);
+    bool valid = size >= sizeof(TextureCacheHeader) &&
+                 memcmp(header->magic, TEXTURE_CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == TEXTURE_CACHE_VERSION &&
+                 header->fileSize == size &&
+                 header->format == format && bytesPerPixel > 0 &&
+                 header->tier == (Uint32) tier &&
+                 header->pathHash == assetPackHash(path, strlen(path)) &&
+                 header->sourceStamp == stamp && header->sourceSize == sourceSize &&
+                 header->width > 0 && header->height > 0 && header->width <= INT32_MAX / 4 &&
+                 header->pitch >= header->width * (Uint32) bytesPerPixel &&
+                 header->pixelsOffset % TEXTURE_CACHE_ALIGNMENT == 0 &&
+                 header->pixelsOffset + (Uint64) header->pitch * header->height <= size &&
+                 (!mask || header->maskOffset != 0);
+
+    //an image with no opaque pixel has an empty mask and no bits
+    bool maskBits = valid && mask && header->maskBounds[2] > 0 && header->maskBounds[3] > 0;
+    if (maskBits) {
+        valid = header->maskStride >= ((Uint32) header->maskBounds[2] + 7) / 8 &&
+                header->maskOffset + (Uint64) header->maskStride * (Uint32) header->maskBounds[3] <= size;
+    }
+
+    SDL_Surface *surface = NULL;
+    if (valid) {
+        surface = SDL_CreateRGBSurfaceWithFormatFrom((char *) header + header->pixelsOffset, (int) header->width,
+                                                     (int) header->height, bytesPerPixel * 8, (int) header->pitch,
+                                                     format);
+    }
+    if (surface && mask) {
+        memset(mask, 0, sizeof(*mask));
+        mask->stride = (int) header->maskStride;
+        mask->bounds = (SDL_Rect) {header->maskBounds[0], header->maskBounds[1], header->maskBounds[2],
+                                   header->maskBounds[3]};
+        mask->width = (int) header->maskWidth;
+        mask->height = (int) header->maskHeight;
+        if (maskBits) {
+            size_t bytes = (size_t) header->maskStride * (size_t) header->maskBounds[3];
+            mask->bits = malloc(bytes);
+            if (mask->bits) {
+                memcpy(mask->bits, (const char *) header + header->maskOffset, bytes);
+            } else {
+                memset(mask, 0, sizeof(*mask));
+                SDL_FreeSurface(surface);
+                surface = NULL;
+            }
+        }
+    }
+
+    if (!surface) {
+        mappedFileClose(mapping);
+        free(mapping);
+        return NULL;
+    }
+
+    //pixels are read straight from the page cache, the mapping lives until the surface is freed
+    surface->userdata = mapping;
+    return surface;
+}
+
+void textureCacheFreeSurface(SDL_Surface *surface) {
+    if (!surface) return;
+
+    MappedFile *mapping = surface->userdata;
+    SDL_FreeSurface(surface);
+    if (mapping) {
+        mappedFileClose(mapping);
+        free(mapping);
+    }
+}
+
+// ============================================================================
+// STORE
+// ============================================================================
+
+static bool writePadding(FILE *file, long offset) {
+    static const char padding[TEXTURE_CACHE_ALIGNMENT] = {0};
+    long position = ftell(file);
+    return position >= 0 && position <= offset &&
+           fwrite(padding, 1, (size_t) (offset - position), file) == (size_t) (offset - position);
+}
+
+bool textureCacheStore(const char *path, TextureTier tier, SDL_Surface *surface, const HitMask *mask) {
+    if (!g_cacheDir[0] || !surface) return false;
+
+    Uint64 stamp, sourceSize;
+    if (!sourceStamp(path, &stamp, &sourceSize)) return false;
+
+    Uint32 format = surface->format->format;
+    int bytesPerPixel = SDL_BYTESPERPIXEL(format);
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || bytesPerPixel == 0) return false;
+
+    TextureCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = TEXTURE_CACHE_VERSION;
+    header.format = format;
+    header.tier = (Uint32) tier;
+    header.width = (Uint32) surface->w;
+    header.height = (Uint32) surface->h;
+    header.pitch = header.width * (Uint32) bytesPerPixel; //rows are stored tight whatever the surface pitch
+    header.pathHash = assetPackHash(path, strlen(path));
+    header.sourceStamp = stamp;
+    header.sourceSize = sourceSize;
+    header.pixelsOffset = alignUp(sizeof(TextureCacheHeader));
+    header.fileSize = header.pixelsOffset + header.pitch * header.height;
+
+    size_t maskBytes = 0;
+    if (mask) {
+        header.maskOffset = alignUp(header.fileSize);
+        header.maskStride = (Uint32) mask->stride;
+        header.maskBounds[0] = mask->bounds.x;
+        header.maskBounds[1] = mask->bounds.y;
+        header.maskBounds[2] = mask->bits ? mask->bounds.w : 0;
+        header.maskBounds[3] = mask->bits ? mask->bounds.h : 0;
+        header.maskWidth = (Uint32) mask->width;
+        header.maskHeight = (Uint32) mask->height;
+        maskBytes = mask->bits ? (size_t) mask->stride * mask->bounds.h : 0;
+        header.fileSize = header.maskOffset + (Uint32) maskBytes;
+    }
+
+    //written under a temporary name so a reader never maps half an entry
+    char file[640], temp[680];
+    entryPath(file, sizeof(file), path, tier);
+    FILE *out = mappedFileCreate(file, temp, sizeof(temp));
+    if (!out) return false;
+
+    bool locked = SDL_MUSTLOCK(surface);
+    if (locked && SDL_LockSurface(surface) != 0) return mappedFileCommit(out, temp, file, false);
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 && writePadding(out, (long) header.pixelsOffset);
+    for (int y = 0; y < surface->h && ok; y++) {
+        ok = fwrite((const char *) surface->pixels + (size_t) y * surface->pitch, header.pitch, 1, out) == 1;
+    }
+    if (locked) SDL_UnlockSurface(surface);
+    if (ok && mask) ok = writePadding(out, (long) header.maskOffset);
+    if (ok && maskBytes > 0) ok = fwrite(mask->bits, maskBytes, 1, out) == 1;
+
+    return mappedFileCommit(out, temp, file, ok);
+}
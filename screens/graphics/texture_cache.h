@@ -0,0 +1,30 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#include "hit_mask.h"
+#include "texture_tier.h"
+
+//decoded images kept on disk in the format the renderer takes, so a warm start maps pixels instead of inflating PNGs
+//an entry is found by the image path and tier, and only used while the source size and hash or mtime still match
+#define TEXTURE_CACHE_APP_NAME "Hangman"
+
+//dir NULL keeps the cache in the user's pref directory, false leaves the cache off and every load a miss
+bool textureCacheInit(const char *dir);
+
+//the first 32 bit format with alpha the renderer lists, what SDL_CreateTextureFromSurface() copies without converting
+Uint32 textureCacheNativeFormat(SDL_Renderer *renderer);
+
+//returns NULL on a miss, mask is filled when it is not NULL and the entry was stored with one
+//the surface views the mapped entry, free it with textureCacheFreeSurface() so the mapping goes with it
+SDL_Surface *textureCacheLoad(const char *path, TextureTier tier, Uint32 format, HitMask *mask);
+
+//surface has to be in the format later loads ask for, mask may be NULL
+bool textureCacheStore(const char *path, TextureTier tier, SDL_Surface *surface, const HitMask *mask);
+
+//frees any surface, one from textureCacheLoad() also unmaps its entry
+void textureCacheFreeSurface(SDL_Surface *surface);
+
+#endif
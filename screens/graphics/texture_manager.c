@@ -4,6 +4,15 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "asset_source.h"
+#include "texture_cache.h"
+#include "texture_paths.h"
+#include "texture_tier.h"
+#include "../../utility/job_pool.h"
+
+#define BACKGROUND_FRAME_PATH "resources/textures/ingame_ui/background_frames/background_frame_%03d.png"
+#define BACKGROUND_ANIM_PATH "resources/textures/ingame_ui/background.hanim"
+
 //global texture instances
 MainMenuTextures g_mainMenuTextures = {0};
 IngameUITextures g_ingameUITextures = {0};
@@ -19,7 +28,6 @@ static struct {
 
     SDL_Surface *about_bg;
 
-    SDL_Surface *ingame_frames[180];
     SDL_Surface *ingame_lives[7];
     SDL_Surface *ingame_pause;
     SDL_Surface *ingame_lettersPull;
@@ -28,12 +36,56 @@ static struct {
     SDL_Surface *ingame_powerBoxes[9];
 } g_loadedSurfaces = {0};
 
+//hit masks of the clickable images, taken from the full size image before it is filtered down
+static struct {
+    HitMask mainMenu_start;
+    HitMask mainMenu_about;
+    HitMask ingame_lettersPull;
+    HitMask ingame_lettersPulled;
+    HitMask ingame_powerBoxes[9];
+} g_loadedMasks = {0};
+
+//stacked clickable images merged into one lookup each at the end of loading
+static struct {
+    LabelMap mainMenu_buttons;
+    LabelMap ingame_powerBoxes;
+} g_loadedLabels = {0};
+
+//one image the loading thread decodes, run as a job on the decode pool, then uploaded on the main thread
+typedef struct {
+    char path[128];
+    SDL_Surface **surface;
+    SDL_Texture **texture; //slot in the staged texture sets
+    HitMask *mask;         //NULL unless the image is hit tested
+} DecodeJob;
+
+#define LOAD_ITEM_COUNT (5 + 1 + 7 + 1 + 2 + 1 + 9) //26 images, the background streams separately
+
+static DecodeJob g_decodeJobs[LOAD_ITEM_COUNT];
+static int g_decodeJobCount = 0;
+static int g_itemsUploaded = 0; //only touched on the main thread
+
+//textures are uploaded into these over several frames and swapped in together once all are done
+static MainMenuTextures g_stagedMainMenu;
+static IngameUITextures g_stagedIngame; //the background stream is never staged
+static AboutSectionTextures g_stagedAbout;
+
 //threading state
 static SDL_Thread *g_loadThread = NULL;
-static SDL_atomic_t g_loadProgress;
+static SDL_atomic_t g_itemsDecoded; //images finished by the decode jobs
+static SDL_atomic_t g_cacheHits;    //images of this load mapped from the texture cache instead of decoded
 static SDL_atomic_t g_surfacesLoaded;
 static SDL_atomic_t g_texturesCreated;
 
+//tier the loading thread decodes at, and the tier of the textures on screen
+static TextureTier g_loadTier = TEXTURE_TIER_FULL;
+static TextureTier g_screenTier = TEXTURE_TIER_FULL;
+static bool g_texturesOnScreen = false;
+
+//pixel format of the renderer, decoded images are converted to it once and cached that way
+static Uint32 g_cacheFormat = SDL_PIXELFORMAT_ARGB8888;
+static bool g_cacheReady = false;
+
 // ============================================================================
 // MAIN MENU TEXTURES
 // ============================================================================
@@ -44,33 +96,45 @@ bool textureManagerInitMainMenu(SDL_Renderer *renderer) {
         return false;
     }
 
-    g_mainMenuTextures.background = IMG_LoadTexture(renderer, "resources/textures/main_menu/background.png");
+    g_mainMenuTextures.background = assetSourceLoadTexture(renderer,
+                                                           g_texturePaths[TEXTURE_MAIN_MENU_BACKGROUND]);
     if (!g_mainMenuTextures.background) {
         printf("[ERROR] Failed to load main menu background: %s\n", IMG_GetError());
         return false;
     }
 
-    g_mainMenuTextures.startSurface = IMG_Load("resources/textures/main_menu/start.png");
-    if (!g_mainMenuTextures.startSurface) {
+    HitMask buttonMasks[2] = {0};
+
+    SDL_Surface *startSurf = assetSourceLoadImage(g_texturePaths[TEXTURE_MAIN_MENU_START]);
+    if (!startSurf) {
         printf("[ERROR] Failed to load start surface: %s\n", IMG_GetError());
         return false;
     }
-    g_mainMenuTextures.start = SDL_CreateTextureFromSurface(renderer, g_mainMenuTextures.startSurface);
+    hitMaskFromSurface(&buttonMasks[MAIN_MENU_LABEL_START - 1], startSurf);
+    g_mainMenuTextures.start = SDL_CreateTextureFromSurface(renderer, startSurf);
+    SDL_FreeSurface(startSurf);
 
-    SDL_Surface *startHoverSurf = IMG_Load("resources/textures/main_menu/start_hover.png");
+    SDL_Surface *startHoverSurf = assetSourceLoadImage(g_texturePaths[TEXTURE_MAIN_MENU_START_HOVER]);
     if (startHoverSurf) {
         g_mainMenuTextures.startHover = SDL_CreateTextureFromSurface(renderer, startHoverSurf);
         SDL_FreeSurface(startHoverSurf);
     }
 
-    g_mainMenuTextures.aboutSurface = IMG_Load("resources/textures/main_menu/about.png");
-    if (!g_mainMenuTextures.aboutSurface) {
+    SDL_Surface *aboutSurf = assetSourceLoadImage(g_texturePaths[TEXTURE_MAIN_MENU_ABOUT]);
+    if (!aboutSurf) {
         printf("[ERROR] Failed to load about surface: %s\n", IMG_GetError());
+        hitMaskDestroy(&buttonMasks[MAIN_MENU_LABEL_START - 1]);
         return false;
     }
-    g_mainMenuTextures.about = SDL_CreateTextureFromSurface(renderer, g_mainMenuTextures.aboutSurface);
+    hitMaskFromSurface(&buttonMasks[MAIN_MENU_LABEL_ABOUT - 1], aboutSurf);
+    g_mainMenuTextures.about = SDL_CreateTextureFromSurface(renderer, aboutSurf);
+    SDL_FreeSurface(aboutSurf);
 
-    SDL_Surface *aboutHoverSurf = IMG_Load("resources/textures/main_menu/about_hover.png");
+    labelMapBuild(&g_mainMenuTextures.buttons, buttonMasks, 2);
+    hitMaskDestroy(&buttonMasks[0]);
+    hitMaskDestroy(&buttonMasks[1]);
+
+    SDL_Surface *aboutHoverSurf = assetSourceLoadImage(g_texturePaths[TEXTURE_MAIN_MENU_ABOUT_HOVER]);
     if (aboutHoverSurf) {
         g_mainMenuTextures.aboutHover = SDL_CreateTextureFromSurface(renderer, aboutHoverSurf);
         SDL_FreeSurface(aboutHoverSurf);
@@ -83,10 +147,9 @@ void textureManagerDestroyMainMenu(void) {
     if (g_mainMenuTextures.background) SDL_DestroyTexture(g_mainMenuTextures.background);
     if (g_mainMenuTextures.start) SDL_DestroyTexture(g_mainMenuTextures.start);
     if (g_mainMenuTextures.startHover) SDL_DestroyTexture(g_mainMenuTextures.startHover);
-    if (g_mainMenuTextures.startSurface) SDL_FreeSurface(g_mainMenuTextures.startSurface);
+    labelMapDestroy(&g_mainMenuTextures.buttons);
     if (g_mainMenuTextures.about) SDL_DestroyTexture(g_mainMenuTextures.about);
     if (g_mainMenuTextures.aboutHover) SDL_DestroyTexture(g_mainMenuTextures.aboutHover);
-    if (g_mainMenuTextures.aboutSurface) SDL_FreeSurface(g_mainMenuTextures.aboutSurface);
 
     memset(&g_mainMenuTextures, 0, sizeof(MainMenuTextures));
 }
@@ -95,23 +158,30 @@ void textureManagerDestroyMainMenu(void) {
 // INGAME UI TEXTURES
 // ============================================================================
 
-bool textureManagerInitIngameUi(SDL_Renderer *renderer) {
-    char path[512];
+//prefers the packed animation, the numbered frames are the fallback when anim_packer has not been run
+static bool openBackground(void) {
+    if (animStreamOpenPacked(&g_ingameUITextures.background, BACKGROUND_ANIM_PATH)) return true;
+    return animStreamOpen(&g_ingameUITextures.background, BACKGROUND_FRAME_PATH, BACKGROUND_FRAME_COUNT);
+}
 
-    for (int i = 0; i < 180; i++) {
-        snprintf(path, sizeof(path), "resources/textures/ingame_ui/background_frames/background_frame_%03d.bmp", i + 1);
-        SDL_Surface *surf = SDL_LoadBMP(path);
-        if (!surf) {
-            g_ingameUITextures.frames[i] = NULL;
-            continue;
-        }
-        g_ingameUITextures.frames[i] = SDL_CreateTextureFromSurface(renderer, surf);
-        SDL_FreeSurface(surf);
+//a missing letters image is replaced by the other one, each side owns its own copy of the mask
+static void useLettersFallback(void) {
+    if (!g_ingameUITextures.lettersTex[0] && g_ingameUITextures.lettersTex[1]) {
+        g_ingameUITextures.lettersTex[0] = g_ingameUITextures.lettersTex[1];
+        hitMaskCopy(&g_ingameUITextures.lettersMask[0], &g_ingameUITextures.lettersMask[1]);
     }
+    if (!g_ingameUITextures.lettersTex[1] && g_ingameUITextures.lettersTex[0]) {
+        g_ingameUITextures.lettersTex[1] = g_ingameUITextures.lettersTex[0];
+        hitMaskCopy(&g_ingameUITextures.lettersMask[1], &g_ingameUITextures.lettersMask[0]);
+    }
+}
+
+bool textureManagerInitIngameUi(SDL_Renderer *renderer) {
+    //the background decodes on its own thread while the rest loads
+    openBackground();
 
     for (int i = 0; i <= 6; i++) {
-        snprintf(path, sizeof(path), "resources/textures/ingame_ui/%d_lives.png", i);
-        SDL_Surface *surf = IMG_Load(path);
+        SDL_Surface *surf = assetSourceLoadImage(g_texturePaths[TEXTURE_LIVES_FIRST + i]);
         if (!surf) {
             g_ingameUITextures.livesTextures[i] = NULL;
             continue;
@@ -120,58 +190,51 @@ bool textureManagerInitIngameUi(SDL_Renderer *renderer) {
         SDL_FreeSurface(surf);
     }
 
-    SDL_Surface *surf = IMG_Load("resources/textures/ingame_ui/pause_menu.png");
+    SDL_Surface *surf = assetSourceLoadImage(g_texturePaths[TEXTURE_PAUSE_MENU]);
     if (surf) {
         g_ingameUITextures.pauseTex = SDL_CreateTextureFromSurface(renderer, surf);
         SDL_FreeSurface(surf);
     }
 
-    surf = IMG_Load("resources/textures/ingame_ui/letters_used_pull.png");
+    surf = assetSourceLoadImage(g_texturePaths[TEXTURE_LETTERS_PULL]);
     if (surf) {
-        g_ingameUITextures.lettersSurf[0] = surf;
+        hitMaskFromSurface(&g_ingameUITextures.lettersMask[0], surf);
         g_ingameUITextures.lettersTex[0] = SDL_CreateTextureFromSurface(renderer, surf);
+        SDL_FreeSurface(surf);
     }
 
-    surf = IMG_Load("resources/textures/ingame_ui/letters_used_pulled.png");
+    surf = assetSourceLoadImage(g_texturePaths[TEXTURE_LETTERS_PULLED]);
     if (surf) {
-        g_ingameUITextures.lettersSurf[1] = surf;
+        hitMaskFromSurface(&g_ingameUITextures.lettersMask[1], surf);
         g_ingameUITextures.lettersTex[1] = SDL_CreateTextureFromSurface(renderer, surf);
+        SDL_FreeSurface(surf);
     }
 
-    if (!g_ingameUITextures.lettersTex[0] && g_ingameUITextures.lettersTex[1]) {
-        g_ingameUITextures.lettersTex[0] = g_ingameUITextures.lettersTex[1];
-        g_ingameUITextures.lettersSurf[0] = g_ingameUITextures.lettersSurf[1];
-    }
-    if (!g_ingameUITextures.lettersTex[1] && g_ingameUITextures.lettersTex[0]) {
-        g_ingameUITextures.lettersTex[1] = g_ingameUITextures.lettersTex[0];
-        g_ingameUITextures.lettersSurf[1] = g_ingameUITextures.lettersSurf[0];
-    }
+    useLettersFallback();
 
-    surf = IMG_Load("resources/textures/ingame_ui/power_ui/power.png");
+    surf = assetSourceLoadImage(g_texturePaths[TEXTURE_POWER_BACKGROUND]);
     if (surf) {
         g_ingameUITextures.powerUI_bg = SDL_CreateTextureFromSurface(renderer, surf);
         SDL_FreeSurface(surf);
     }
 
+    HitMask boxMasks[9] = {0};
     for (int i = 0; i < 9; i++) {
-        snprintf(path, sizeof(path), "resources/textures/ingame_ui/power_ui/box%d.png", i + 1);
-        SDL_Surface *surf = IMG_Load(path);
+        SDL_Surface *surf = assetSourceLoadImage(g_texturePaths[TEXTURE_POWER_BOX_FIRST + i]);
         if (surf) {
-            g_ingameUITextures.powerUI_boxSurfs[i] = surf;
+            hitMaskFromSurface(&boxMasks[i], surf);
             g_ingameUITextures.powerUI_boxes[i] = SDL_CreateTextureFromSurface(renderer, surf);
+            SDL_FreeSurface(surf);
         }
     }
+    labelMapBuild(&g_ingameUITextures.powerUI_boxLabels, boxMasks, 9);
+    for (int i = 0; i < 9; i++) hitMaskDestroy(&boxMasks[i]);
 
     return true;
 }
 
-void textureManagerDestroyIngameUi(void) {
-    for (int i = 0; i < 180; i++) {
-        if (g_ingameUITextures.frames[i]) {
-            SDL_DestroyTexture(g_ingameUITextures.frames[i]);
-        }
-    }
-
+//everything but the background stream, which changes tier in place
+static void destroyIngameImages(void) {
     for (int i = 0; i <= 6; i++) {
         if (g_ingameUITextures.livesTextures[i]) {
             SDL_DestroyTexture(g_ingameUITextures.livesTextures[i]);
@@ -188,13 +251,8 @@ void textureManagerDestroyIngameUi(void) {
         SDL_DestroyTexture(g_ingameUITextures.lettersTex[1]);
     }
 
-    if (g_ingameUITextures.lettersSurf[0] &&
-        g_ingameUITextures.lettersSurf[0] != g_ingameUITextures.lettersSurf[1]) {
-        SDL_FreeSurface(g_ingameUITextures.lettersSurf[0]);
-    }
-    if (g_ingameUITextures.lettersSurf[1]) {
-        SDL_FreeSurface(g_ingameUITextures.lettersSurf[1]);
-    }
+    hitMaskDestroy(&g_ingameUITextures.lettersMask[0]);
+    hitMaskDestroy(&g_ingameUITextures.lettersMask[1]);
 
     if (g_ingameUITextures.powerUI_bg) SDL_DestroyTexture(g_ingameUITextures.powerUI_bg);
 
@@ -202,11 +260,19 @@ void textureManagerDestroyIngameUi(void) {
         if (g_ingameUITextures.powerUI_boxes[i]) {
             SDL_DestroyTexture(g_ingameUITextures.powerUI_boxes[i]);
         }
-        if (g_ingameUITextures.powerUI_boxSurfs[i]) {
-            SDL_FreeSurface(g_ingameUITextures.powerUI_boxSurfs[i]);
-        }
     }
 
+    memset(g_ingameUITextures.livesTextures, 0, sizeof(g_ingameUITextures.livesTextures));
+    g_ingameUITextures.pauseTex = NULL;
+    memset(g_ingameUITextures.lettersTex, 0, sizeof(g_ingameUITextures.lettersTex));
+    g_ingameUITextures.powerUI_bg = NULL;
+    memset(g_ingameUITextures.powerUI_boxes, 0, sizeof(g_ingameUITextures.powerUI_boxes));
+    labelMapDestroy(&g_ingameUITextures.powerUI_boxLabels);
+}
+
+void textureManagerDestroyIngameUi(void) {
+    animStreamClose(&g_ingameUITextures.background);
+    destroyIngameImages();
     memset(&g_ingameUITextures, 0, sizeof(IngameUITextures));
 }
 
@@ -220,7 +286,7 @@ bool textureManagerInitAboutSection(SDL_Renderer *renderer) {
         return false;
     }
 
-    g_aboutTextures.background = IMG_LoadTexture(renderer, "resources/textures/about_section/background.png");
+    g_aboutTextures.background = assetSourceLoadTexture(renderer, g_texturePaths[TEXTURE_ABOUT_BACKGROUND]);
     if (!g_aboutTextures.background) {
         printf("[ERROR] Failed to load about section background: %s\n", IMG_GetError());
         return false;
@@ -248,7 +314,36 @@ bool textureManagerInit(SDL_Renderer *renderer) {
 // GLOBAL CLEANUP
 // ============================================================================
 
+//frees whatever a load thread decoded that was never turned into textures
+static void freeLoadedSurfaces(void) {
+    SDL_Surface **surfaces = (SDL_Surface **) &g_loadedSurfaces;
+    for (size_t i = 0; i < sizeof(g_loadedSurfaces) / sizeof(SDL_Surface *); i++) {
+        textureCacheFreeSurface(surfaces[i]);
+    }
+    memset(&g_loadedSurfaces, 0, sizeof(g_loadedSurfaces));
+
+    HitMask *masks = (HitMask *) &g_loadedMasks;
+    for (size_t i = 0; i < sizeof(g_loadedMasks) / sizeof(HitMask); i++) {
+        hitMaskDestroy(&masks[i]);
+    }
+
+    labelMapDestroy(&g_loadedLabels.mainMenu_buttons);
+    labelMapDestroy(&g_loadedLabels.ingame_powerBoxes);
+}
+
 void textureManagerDestroyAll(void) {
+    if (g_loadThread) {
+        SDL_WaitThread(g_loadThread, NULL);
+        g_loadThread = NULL;
+    }
+    freeLoadedSurfaces();
+    for (int i = 0; i < g_itemsUploaded; i++) {
+        if (*g_decodeJobs[i].texture) SDL_DestroyTexture(*g_decodeJobs[i].texture);
+        *g_decodeJobs[i].texture = NULL;
+    }
+    g_itemsUploaded = 0;
+    g_texturesOnScreen = false;
+
     textureManagerDestroyMainMenu();
     textureManagerDestroyIngameUi();
     textureManagerDestroyAboutSection();
@@ -259,81 +354,147 @@ void textureManagerDestroyAll(void) {
 // THREADED LOADING IMPLEMENTATION
 // ============================================================================
 
-static int surfaceLoadThread(void *data) {
-    char path[512];
-    int totalItems = 5 + 1 + 180 + 7 + 1 + 2 + 1 + 9; //total surface count = 206
-    int currentItem = 0;
+//filters a decoded image down to the load tier, the full size surface is freed
+static SDL_Surface *toLoadTier(SDL_Surface *surf) {
+    if (!surf || g_loadTier == TEXTURE_TIER_FULL) return surf;
 
-    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
-        printf("[ERROR] SDL_image init failed in thread: %s\n", IMG_GetError());
-        return 1;
-    }
+    SDL_Surface *scaled = textureTierScaleSurface(surf, g_loadTier);
+    SDL_FreeSurface(surf);
+    return scaled;
+}
+
+static SDL_Surface *loadTiered(const char *path) {
+    return toLoadTier(assetSourceLoadImage(path));
+}
 
-    SDL_AtomicSet(&g_loadProgress, 0);
+//the mask is taken at full size so clicks stay pixel exact at every tier
+static SDL_Surface *loadHitTested(const char *path, HitMask *mask) {
+    SDL_Surface *surf = assetSourceLoadImage(path);
+    if (surf) hitMaskFromSurface(mask, surf);
+    return toLoadTier(surf);
+}
 
-    // Load main menu surfaces
-    g_loadedSurfaces.mainMenu_bg = IMG_Load("resources/textures/main_menu/background.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+static void addDecodeJob(const char *path, SDL_Surface **surface, SDL_Texture **texture, HitMask *mask) {
+    DecodeJob *job = &g_decodeJobs[g_decodeJobCount++];
+    snprintf(job->path, sizeof(job->path), "%s", path);
+    job->surface = surface;
+    job->texture = texture;
+    job->mask = mask;
+}
 
-    g_loadedSurfaces.mainMenu_start = IMG_Load("resources/textures/main_menu/start.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+//converted once here so the upload, and every warm start after it, is a plain copy
+static SDL_Surface *toCacheFormat(SDL_Surface *surf) {
+    if (!surf || surf->format->format == g_cacheFormat) return surf;
 
-    g_loadedSurfaces.mainMenu_startHover = IMG_Load("resources/textures/main_menu/start_hover.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(surf, g_cacheFormat, 0);
+    if (!converted) return surf;
+    SDL_FreeSurface(surf);
+    return converted;
+}
 
-    g_loadedSurfaces.mainMenu_about = IMG_Load("resources/textures/main_menu/about.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+//jobs write to different slots of g_loadedSurfaces and g_loadedMasks, only the counters are shared
+static void decodeJob(void *data) {
+    DecodeJob *job = data;
+    SDL_Surface *surf = textureCacheLoad(job->path, g_loadTier, g_cacheFormat, job->mask);
+    if (surf) {
+        SDL_AtomicAdd(&g_cacheHits, 1);
+    } else {
+        surf = toCacheFormat(job->mask ? loadHitTested(job->path, job->mask) : loadTiered(job->path));
+        if (surf) textureCacheStore(job->path, g_loadTier, surf, job->mask);
+    }
+    *job->surface = surf;
+    SDL_AtomicAdd(&g_itemsDecoded, 1);
+}
 
-    g_loadedSurfaces.mainMenu_aboutHover = IMG_Load("resources/textures/main_menu/about_hover.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+static void queueDecodeJobs(void) {
+    g_decodeJobCount = 0;
 
-    // Load about section
-    g_loadedSurfaces.about_bg = IMG_Load("resources/textures/about_section/background.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+    // Main menu
+    addDecodeJob(g_texturePaths[TEXTURE_MAIN_MENU_BACKGROUND], &g_loadedSurfaces.mainMenu_bg,
+                 &g_stagedMainMenu.background, NULL);
+    addDecodeJob(g_texturePaths[TEXTURE_MAIN_MENU_START], &g_loadedSurfaces.mainMenu_start,
+                 &g_stagedMainMenu.start, &g_loadedMasks.mainMenu_start);
+    addDecodeJob(g_texturePaths[TEXTURE_MAIN_MENU_START_HOVER], &g_loadedSurfaces.mainMenu_startHover,
+                 &g_stagedMainMenu.startHover, NULL);
+    addDecodeJob(g_texturePaths[TEXTURE_MAIN_MENU_ABOUT], &g_loadedSurfaces.mainMenu_about,
+                 &g_stagedMainMenu.about, &g_loadedMasks.mainMenu_about);
+    addDecodeJob(g_texturePaths[TEXTURE_MAIN_MENU_ABOUT_HOVER], &g_loadedSurfaces.mainMenu_aboutHover,
+                 &g_stagedMainMenu.aboutHover, NULL);
 
-    // Load ingame frames (180 BMPs)
-    for (int i = 0; i < 180; i++) {
-        snprintf(path, sizeof(path), "resources/textures/ingame_ui/background_frames/background_frame_%03d.png", i + 1);
-        g_loadedSurfaces.ingame_frames[i] = IMG_Load(path);
-        currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
-    }
+    // About section
+    addDecodeJob(g_texturePaths[TEXTURE_ABOUT_BACKGROUND], &g_loadedSurfaces.about_bg,
+                 &g_stagedAbout.background, NULL);
 
-    // Load lives (7 PNGs)
+    // Lives (7 PNGs)
     for (int i = 0; i <= 6; i++) {
-        snprintf(path, sizeof(path), "resources/textures/ingame_ui/%d_lives.png", i);
-        g_loadedSurfaces.ingame_lives[i] = IMG_Load(path);
-        currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+        addDecodeJob(g_texturePaths[TEXTURE_LIVES_FIRST + i], &g_loadedSurfaces.ingame_lives[i],
+                     &g_stagedIngame.livesTextures[i], NULL);
     }
 
-    // Load pause menu
-    g_loadedSurfaces.ingame_pause = IMG_Load("resources/textures/ingame_ui/pause_menu.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+    // Pause menu
+    addDecodeJob(g_texturePaths[TEXTURE_PAUSE_MENU], &g_loadedSurfaces.ingame_pause,
+                 &g_stagedIngame.pauseTex, NULL);
 
-    // Load letters
-    g_loadedSurfaces.ingame_lettersPull = IMG_Load("resources/textures/ingame_ui/letters_used_pull.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
-
-    g_loadedSurfaces.ingame_lettersPulled = IMG_Load("resources/textures/ingame_ui/letters_used_pulled.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
-
-    // Load power UI
-    g_loadedSurfaces.ingame_powerBg = IMG_Load("resources/textures/ingame_ui/power_ui/power.png");
-    currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+    // Letters
+    addDecodeJob(g_texturePaths[TEXTURE_LETTERS_PULL], &g_loadedSurfaces.ingame_lettersPull,
+                 &g_stagedIngame.lettersTex[0], &g_loadedMasks.ingame_lettersPull);
+    addDecodeJob(g_texturePaths[TEXTURE_LETTERS_PULLED], &g_loadedSurfaces.ingame_lettersPulled,
+                 &g_stagedIngame.lettersTex[1], &g_loadedMasks.ingame_lettersPulled);
 
+    // Power UI
+    addDecodeJob(g_texturePaths[TEXTURE_POWER_BACKGROUND], &g_loadedSurfaces.ingame_powerBg,
+                 &g_stagedIngame.powerUI_bg, NULL);
     for (int i = 0; i < 9; i++) {
-        snprintf(path, sizeof(path), "resources/textures/ingame_ui/power_ui/box%d.png", i + 1);
-        g_loadedSurfaces.ingame_powerBoxes[i] = IMG_Load(path);
-        currentItem++; SDL_AtomicSet(&g_loadProgress, (int)((currentItem / (float)totalItems) * 100.0f));
+        addDecodeJob(g_texturePaths[TEXTURE_POWER_BOX_FIRST + i], &g_loadedSurfaces.ingame_powerBoxes[i],
+                     &g_stagedIngame.powerUI_boxes[i], &g_loadedMasks.ingame_powerBoxes[i]);
     }
+}
+
+static int surfaceLoadThread(void *data) {
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        printf("[ERROR] SDL_image init failed in thread: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    queueDecodeJobs();
+    Uint32 start = SDL_GetTicks();
+
+    //every image decodes on its own job, idle workers steal from busy ones so the slowest image sets the pace
+    JobPool pool;
+    int threadCount = 0;
+    if (jobPoolCreate(&pool, 0)) {
+        threadCount = pool.threadCount;
+        for (int i = 0; i < g_decodeJobCount; i++) {
+            if (!jobPoolSubmit(&pool, decodeJob, &g_decodeJobs[i])) decodeJob(&g_decodeJobs[i]);
+        }
+        jobPoolWait(&pool);
+        jobPoolDestroy(&pool);
+    } else {
+        printf("[WARNING] Decode pool unavailable, decoding on the loading thread\n");
+        for (int i = 0; i < g_decodeJobCount; i++) decodeJob(&g_decodeJobs[i]);
+    }
+    int hits = SDL_AtomicGet(&g_cacheHits);
+    printf("[TIMING] Loaded %d images on %d threads in %u ms, texture cache: %d hits, %d misses\n", g_decodeJobCount,
+           threadCount > 0 ? threadCount : 1, SDL_GetTicks() - start, hits, g_decodeJobCount - hits);
+
+    //the per image masks of stacked images are only needed to build their label map
+    HitMask buttonMasks[2] = {g_loadedMasks.mainMenu_start, g_loadedMasks.mainMenu_about};
+    labelMapBuild(&g_loadedLabels.mainMenu_buttons, buttonMasks, 2);
+    labelMapBuild(&g_loadedLabels.ingame_powerBoxes, g_loadedMasks.ingame_powerBoxes, 9);
+    hitMaskDestroy(&g_loadedMasks.mainMenu_start);
+    hitMaskDestroy(&g_loadedMasks.mainMenu_about);
+    for (int i = 0; i < 9; i++) hitMaskDestroy(&g_loadedMasks.ingame_powerBoxes[i]);
 
-    SDL_AtomicSet(&g_loadProgress, 100);
     SDL_AtomicSet(&g_surfacesLoaded, 1);
 
     return 0;
 }
 
-bool textureManagerStartAsyncLoad(void) {
-    SDL_AtomicSet(&g_loadProgress, 0);
+static bool startLoadThread(TextureTier tier) {
+    g_loadTier = tier;
+    SDL_AtomicSet(&g_itemsDecoded, 0);
+    SDL_AtomicSet(&g_cacheHits, 0);
+    g_itemsUploaded = 0;
     SDL_AtomicSet(&g_surfacesLoaded, 0);
     SDL_AtomicSet(&g_texturesCreated, 0);
 
@@ -346,117 +507,122 @@ bool textureManagerStartAsyncLoad(void) {
     return true;
 }
 
-bool textureManagerProcessLoadedSurfaces(SDL_Renderer *renderer) {
-    if (!SDL_AtomicGet(&g_surfacesLoaded)) {
-        return false; // Still loading
+//decodes at the tier that matches the renderer output, so memory and upload time follow the window, not the art
+bool textureManagerStartAsyncLoad(SDL_Renderer *renderer) {
+    if (!g_cacheReady) {
+        textureCacheInit(NULL);
+        g_cacheReady = true;
     }
+    g_cacheFormat = textureCacheNativeFormat(renderer);
+
+    TextureTier tier = textureTierForRenderer(renderer);
+    printf("Loading textures at %s resolution\n", textureTierName(tier));
+    return startLoadThread(tier);
+}
 
+//swaps the staged textures in for the ones on screen, all of them in the same frame
+static void swapInStagedTextures(void) {
+    // A reload at another tier replaces the textures on screen
+    if (g_texturesOnScreen) {
+        textureManagerDestroyMainMenu();
+        textureManagerDestroyAboutSection();
+        destroyIngameImages();
+    }
+
+    // Main menu and about section
+    g_mainMenuTextures = g_stagedMainMenu;
+    g_mainMenuTextures.buttons = g_loadedLabels.mainMenu_buttons;
+    g_aboutTextures = g_stagedAbout;
+
+    // Ingame, field by field since the background stream worker reads the same struct
+    memcpy(g_ingameUITextures.livesTextures, g_stagedIngame.livesTextures, sizeof(g_ingameUITextures.livesTextures));
+    g_ingameUITextures.pauseTex = g_stagedIngame.pauseTex;
+    memcpy(g_ingameUITextures.lettersTex, g_stagedIngame.lettersTex, sizeof(g_ingameUITextures.lettersTex));
+    g_ingameUITextures.lettersMask[0] = g_loadedMasks.ingame_lettersPull;
+    g_ingameUITextures.lettersMask[1] = g_loadedMasks.ingame_lettersPulled;
+    useLettersFallback();
+    g_ingameUITextures.powerUI_bg = g_stagedIngame.powerUI_bg;
+    memcpy(g_ingameUITextures.powerUI_boxes, g_stagedIngame.powerUI_boxes, sizeof(g_ingameUITextures.powerUI_boxes));
+    g_ingameUITextures.powerUI_boxLabels = g_loadedLabels.ingame_powerBoxes;
+
+    // Ingame background, only a ring of frames ahead of the one on screen is ever decoded
+    if (!g_ingameUITextures.background.worker) openBackground();
+    animStreamSetTier(&g_ingameUITextures.background, g_loadTier);
+
+    //every texture, mask and label map is now handed over
+    memset(&g_stagedMainMenu, 0, sizeof(g_stagedMainMenu));
+    memset(&g_stagedIngame, 0, sizeof(g_stagedIngame));
+    memset(&g_stagedAbout, 0, sizeof(g_stagedAbout));
+    memset(&g_loadedMasks, 0, sizeof(g_loadedMasks));
+    memset(&g_loadedLabels, 0, sizeof(g_loadedLabels));
+    g_screenTier = g_loadTier;
+    g_texturesOnScreen = true;
+}
+
+//uploads decoded images until budgetMs has passed, at least one per call, a negative budget uploads them all
+//returns true once every texture is on screen
+bool textureManagerUploadStep(SDL_Renderer *renderer, double budgetMs) {
     if (SDL_AtomicGet(&g_texturesCreated)) {
         return true; // Already done
     }
 
+    if (!SDL_AtomicGet(&g_surfacesLoaded)) {
+        return false; // Still decoding
+    }
+
     // Wait for thread to complete
     if (g_loadThread) {
         SDL_WaitThread(g_loadThread, NULL);
         g_loadThread = NULL;
     }
 
-    // Create textures from loaded surfaces on main thread
-
-    // Main menu
-    if (g_loadedSurfaces.mainMenu_bg) {
-        g_mainMenuTextures.background = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.mainMenu_bg);
-        SDL_FreeSurface(g_loadedSurfaces.mainMenu_bg);
-    }
-
-    if (g_loadedSurfaces.mainMenu_start) {
-        g_mainMenuTextures.startSurface = g_loadedSurfaces.mainMenu_start; // Keep surface
-        g_mainMenuTextures.start = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.mainMenu_start);
-    }
-
-    if (g_loadedSurfaces.mainMenu_startHover) {
-        g_mainMenuTextures.startHover = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.mainMenu_startHover);
-        SDL_FreeSurface(g_loadedSurfaces.mainMenu_startHover);
-    }
-
-    if (g_loadedSurfaces.mainMenu_about) {
-        g_mainMenuTextures.aboutSurface = g_loadedSurfaces.mainMenu_about; // Keep surface
-        g_mainMenuTextures.about = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.mainMenu_about);
-    }
-
-    if (g_loadedSurfaces.mainMenu_aboutHover) {
-        g_mainMenuTextures.aboutHover = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.mainMenu_aboutHover);
-        SDL_FreeSurface(g_loadedSurfaces.mainMenu_aboutHover);
-    }
-
-    // About section
-    if (g_loadedSurfaces.about_bg) {
-        g_aboutTextures.background = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.about_bg);
-        SDL_FreeSurface(g_loadedSurfaces.about_bg);
-    }
-
-    // Ingame frames
-    for (int i = 0; i < 180; i++) {
-        if (g_loadedSurfaces.ingame_frames[i]) {
-            g_ingameUITextures.frames[i] = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.ingame_frames[i]);
-            SDL_FreeSurface(g_loadedSurfaces.ingame_frames[i]);
+    Uint64 start = SDL_GetPerformanceCounter();
+    double ticksPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+    while (g_itemsUploaded < g_decodeJobCount) {
+        DecodeJob *job = &g_decodeJobs[g_itemsUploaded++];
+        if (*job->surface) {
+            *job->texture = SDL_CreateTextureFromSurface(renderer, *job->surface);
+            textureCacheFreeSurface(*job->surface);
+            *job->surface = NULL;
         }
-    }
 
-    // Ingame lives
-    for (int i = 0; i <= 6; i++) {
-        if (g_loadedSurfaces.ingame_lives[i]) {
-            g_ingameUITextures.livesTextures[i] = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.ingame_lives[i]);
-            SDL_FreeSurface(g_loadedSurfaces.ingame_lives[i]);
-        }
+        if (budgetMs >= 0.0 && (SDL_GetPerformanceCounter() - start) / ticksPerMs >= budgetMs) break;
     }
+    if (g_itemsUploaded < g_decodeJobCount) return false;
 
-    // Pause
-    if (g_loadedSurfaces.ingame_pause) {
-        g_ingameUITextures.pauseTex = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.ingame_pause);
-        SDL_FreeSurface(g_loadedSurfaces.ingame_pause);
-    }
+    swapInStagedTextures();
+    SDL_AtomicSet(&g_texturesCreated, 1);
+    return true;
+}
 
-    // Letters
-    if (g_loadedSurfaces.ingame_lettersPull) {
-        g_ingameUITextures.lettersSurf[0] = g_loadedSurfaces.ingame_lettersPull; // Keep surface
-        g_ingameUITextures.lettersTex[0] = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.ingame_lettersPull);
-    }
+bool textureManagerProcessLoadedSurfaces(SDL_Renderer *renderer) {
+    return textureManagerUploadStep(renderer, -1.0);
+}
 
-    if (g_loadedSurfaces.ingame_lettersPulled) {
-        g_ingameUITextures.lettersSurf[1] = g_loadedSurfaces.ingame_lettersPulled; // Keep surface
-        g_ingameUITextures.lettersTex[1] = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.ingame_lettersPulled);
-    }
+//call once per frame after loading, a resize into another tier reloads the images in the background
+//the old textures stay on screen until the new ones are ready
+void textureManagerUpdateTier(SDL_Renderer *renderer) {
+    if (!g_texturesOnScreen) return;
 
-    // Fallback for letters
-    if (!g_ingameUITextures.lettersTex[0] && g_ingameUITextures.lettersTex[1]) {
-        g_ingameUITextures.lettersTex[0] = g_ingameUITextures.lettersTex[1];
-        g_ingameUITextures.lettersSurf[0] = g_ingameUITextures.lettersSurf[1];
-    }
-    if (!g_ingameUITextures.lettersTex[1] && g_ingameUITextures.lettersTex[0]) {
-        g_ingameUITextures.lettersTex[1] = g_ingameUITextures.lettersTex[0];
-        g_ingameUITextures.lettersSurf[1] = g_ingameUITextures.lettersSurf[0];
+    if (!SDL_AtomicGet(&g_texturesCreated)) {
+        textureManagerUploadStep(renderer, TEXTURE_UPLOAD_BUDGET_MS);
+        return;
     }
 
-    // Power UI
-    if (g_loadedSurfaces.ingame_powerBg) {
-        g_ingameUITextures.powerUI_bg = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.ingame_powerBg);
-        SDL_FreeSurface(g_loadedSurfaces.ingame_powerBg);
-    }
+    TextureTier tier = textureTierForRenderer(renderer);
+    if (tier == g_screenTier) return;
 
-    for (int i = 0; i < 9; i++) {
-        if (g_loadedSurfaces.ingame_powerBoxes[i]) {
-            g_ingameUITextures.powerUI_boxSurfs[i] = g_loadedSurfaces.ingame_powerBoxes[i]; // Keep surface
-            g_ingameUITextures.powerUI_boxes[i] = SDL_CreateTextureFromSurface(renderer, g_loadedSurfaces.ingame_powerBoxes[i]);
-        }
-    }
+    printf("Output size changed, reloading textures at %s resolution\n", textureTierName(tier));
+    startLoadThread(tier);
+}
 
-    SDL_AtomicSet(&g_texturesCreated, 1);
-    return true;
+TextureTier textureManagerGetTier(void) {
+    return g_screenTier;
 }
 
 float textureManagerGetProgress(void) {
-    return SDL_AtomicGet(&g_loadProgress) / 100.0f;
+    //decoding is the first half of the bar and uploading the second
+    return (SDL_AtomicGet(&g_itemsDecoded) + g_itemsUploaded) / (float) (2 * LOAD_ITEM_COUNT);
 }
 
 bool textureManagerSurfacesLoaded(void) {
@@ -465,4 +631,4 @@ bool textureManagerSurfacesLoaded(void) {
 
 bool textureManagerIsFullyLoaded(void) {
     return SDL_AtomicGet(&g_texturesCreated) == 1;
-}
\ No newline at end of file
+}
@@ -4,26 +4,36 @@
 #include <SDL2/SDL.h>
 #include <stdbool.h>
 
+#include "anim_stream.h"
+#include "hit_mask.h"
+#include "label_map.h"
+#include "texture_tier.h"
+
+#define BACKGROUND_FRAME_COUNT 180
+
+//labels of MainMenuTextures.buttons
+#define MAIN_MENU_LABEL_START 1
+#define MAIN_MENU_LABEL_ABOUT 2
+
 //main menu textures
 typedef struct {
     SDL_Texture *background;
     SDL_Texture *start;
     SDL_Texture *startHover;
-    SDL_Surface *startSurface;
     SDL_Texture *about;
     SDL_Texture *aboutHover;
-    SDL_Surface *aboutSurface;
+    LabelMap buttons; //which button is under a pixel, see MAIN_MENU_LABEL_START
 } MainMenuTextures;
 
 typedef struct {
-    SDL_Texture *frames[180];
+    AnimStream background; //looping background, streamed instead of kept resident
     SDL_Texture *livesTextures[7];
     SDL_Texture *pauseTex;
     SDL_Texture *lettersTex[2];
-    SDL_Surface *lettersSurf[2];
+    HitMask lettersMask[2];
     SDL_Texture *powerUI_bg;
     SDL_Texture *powerUI_boxes[9];
-    SDL_Surface *powerUI_boxSurfs[9];
+    LabelMap powerUI_boxLabels; //box i has label i + 1
 } IngameUITextures;
 
 typedef struct {
@@ -50,11 +60,19 @@ void textureManagerDestroyAll(void);
 // THREADED LOADING API
 // ============================================================================
 
-bool textureManagerStartAsyncLoad(void);
+//decodes at the tier that fits the renderer output size
+bool textureManagerStartAsyncLoad(SDL_Renderer *renderer);
+
+//milliseconds of texture upload per frame, leaves most of a 60 fps frame for drawing and input
+#define TEXTURE_UPLOAD_BUDGET_MS 4.0
 
+//uploads decoded images for up to budgetMs, true once every texture is on screen
+bool textureManagerUploadStep(SDL_Renderer *renderer, double budgetMs);
+
+//uploads every decoded image in one go
 bool textureManagerProcessLoadedSurfaces(SDL_Renderer *renderer);
 
-//get loading progress (0.0 to 1.0)
+//get loading progress (0.0 to 1.0), decoding fills the first half and uploading the second
 float textureManagerGetProgress(void);
 
 //check if surface loading is complete
@@ -63,4 +81,9 @@ bool textureManagerSurfacesLoaded(void);
 //check if texture creation is complete
 bool textureManagerIsFullyLoaded(void);
 
+//call once per frame after loading, reloads in the background when the output size moves to another tier
+void textureManagerUpdateTier(SDL_Renderer *renderer);
+
+TextureTier textureManagerGetTier(void);
+
 #endif
\ No newline at end of file
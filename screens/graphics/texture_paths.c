@@ -0,0 +1,31 @@
+#include "texture_paths.h"
+
+//the one list of image paths, the loaders and the decode benches all read it
+const char *const g_texturePaths[TEXTURE_PATH_COUNT] = {
+        [TEXTURE_MAIN_MENU_BACKGROUND] = "resources/textures/main_menu/background.png",
+        [TEXTURE_MAIN_MENU_START] = "resources/textures/main_menu/start.png",
+        [TEXTURE_MAIN_MENU_START_HOVER] = "resources/textures/main_menu/start_hover.png",
+        [TEXTURE_MAIN_MENU_ABOUT] = "resources/textures/main_menu/about.png",
+        [TEXTURE_MAIN_MENU_ABOUT_HOVER] = "resources/textures/main_menu/about_hover.png",
+        [TEXTURE_ABOUT_BACKGROUND] = "resources/textures/about_section/background.png",
+        [TEXTURE_LIVES_FIRST + 0] = "resources/textures/ingame_ui/0_lives.png",
+        [TEXTURE_LIVES_FIRST + 1] = "resources/textures/ingame_ui/1_lives.png",
+        [TEXTURE_LIVES_FIRST + 2] = "resources/textures/ingame_ui/2_lives.png",
+        [TEXTURE_LIVES_FIRST + 3] = "resources/textures/ingame_ui/3_lives.png",
+        [TEXTURE_LIVES_FIRST + 4] = "resources/textures/ingame_ui/4_lives.png",
+        [TEXTURE_LIVES_FIRST + 5] = "resources/textures/ingame_ui/5_lives.png",
+        [TEXTURE_LIVES_FIRST + 6] = "resources/textures/ingame_ui/6_lives.png",
+        [TEXTURE_PAUSE_MENU] = "resources/textures/ingame_ui/pause_menu.png",
+        [TEXTURE_LETTERS_PULL] = "resources/textures/ingame_ui/letters_used_pull.png",
+        [TEXTURE_LETTERS_PULLED] = "resources/textures/ingame_ui/letters_used_pulled.png",
+        [TEXTURE_POWER_BACKGROUND] = "resources/textures/ingame_ui/power_ui/power.png",
+        [TEXTURE_POWER_BOX_FIRST + 0] = "resources/textures/ingame_ui/power_ui/box1.png",
+        [TEXTURE_POWER_BOX_FIRST + 1] = "resources/textures/ingame_ui/power_ui/box2.png",
+        [TEXTURE_POWER_BOX_FIRST + 2] = "resources/textures/ingame_ui/power_ui/box3.png",
+        [TEXTURE_POWER_BOX_FIRST + 3] = "resources/textures/ingame_ui/power_ui/box4.png",
+        [TEXTURE_POWER_BOX_FIRST + 4] = "resources/textures/ingame_ui/power_ui/box5.png",
+        [TEXTURE_POWER_BOX_FIRST + 5] = "resources/textures/ingame_ui/power_ui/box6.png",
+        [TEXTURE_POWER_BOX_FIRST + 6] = "resources/textures/ingame_ui/power_ui/box7.png",
+        [TEXTURE_POWER_BOX_FIRST + 7] = "resources/textures/ingame_ui/power_ui/box8.png",
+        [TEXTURE_POWER_BOX_FIRST + 8] = "resources/textures/ingame_ui/power_ui/box9.png",
+};
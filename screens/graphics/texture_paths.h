@@ -0,0 +1,23 @@
+#ifndef TEXTURE_PATHS_H
+#define TEXTURE_PATHS_H
+
+//every image the texture manager loads, indexes into g_texturePaths in the order the loading screen decodes them
+typedef enum {
+    TEXTURE_MAIN_MENU_BACKGROUND = 0,
+    TEXTURE_MAIN_MENU_START,
+    TEXTURE_MAIN_MENU_START_HOVER,
+    TEXTURE_MAIN_MENU_ABOUT,
+    TEXTURE_MAIN_MENU_ABOUT_HOVER,
+    TEXTURE_ABOUT_BACKGROUND,
+    TEXTURE_LIVES_FIRST,                        //0_lives to 6_lives
+    TEXTURE_PAUSE_MENU = TEXTURE_LIVES_FIRST + 7,
+    TEXTURE_LETTERS_PULL,
+    TEXTURE_LETTERS_PULLED,
+    TEXTURE_POWER_BACKGROUND,
+    TEXTURE_POWER_BOX_FIRST,                    //box1 to box9
+    TEXTURE_PATH_COUNT = TEXTURE_POWER_BOX_FIRST + 9
+} TexturePath;
+
+extern const char *const g_texturePaths[TEXTURE_PATH_COUNT];
+
+#endif
@@ -0,0 +1,85 @@
+#include "texture_tier.h"
+
+int textureTierDivisor(TextureTier tier) {
+    return 1 << tier;
+}
+
+const char *textureTierName(TextureTier tier) {
+    static const char *names[TEXTURE_TIER_COUNT] = {"full", "half", "quarter"};
+    return tier >= 0 && tier < TEXTURE_TIER_COUNT ? names[tier] : "unknown";
+}
+
+//smallest tier the output does not stretch by more than TEXTURE_TIER_MAX_UPSCALE
+TextureTier textureTierForOutput(int outputW, int outputH) {
+    TextureTier best = TEXTURE_TIER_FULL;
+    for (int tier = TEXTURE_TIER_HALF; tier < TEXTURE_TIER_COUNT; tier++) {
+        float tierW = (float) TEXTURE_SOURCE_WIDTH / textureTierDivisor(tier);
+        float tierH = (float) TEXTURE_SOURCE_HEIGHT / textureTierDivisor(tier);
+        if (outputW > tierW * TEXTURE_TIER_MAX_UPSCALE || outputH > tierH * TEXTURE_TIER_MAX_UPSCALE) break;
+        best = tier;
+    }
+    return best;
+}
+
+//uses the output size in pixels, which is larger than the window size on high dpi displays
+TextureTier textureTierForRenderer(SDL_Renderer *renderer) {
+    int outputW, outputH;
+    if (!renderer || SDL_GetRendererOutputSize(renderer, &outputW, &outputH) != 0) return TEXTURE_TIER_FULL;
+    return textureTierForOutput(outputW, outputH);
+}
+
+//averages every divisor x divisor block of rect into one pixel of dst, dst is addressed at rect / divisor
+//colour is weighted by alpha so transparent pixels do not darken the edges of sprites
+//pitches are in pixels, blocks cut off by the edge of the source are dropped
+void textureTierDownsample(const Uint32 *src, int srcW, int srcH, int srcPitch, Uint32 *dst, int dstPitch,
+                           const SDL_Rect *rect, int divisor) {
+    int x0 = rect->x / divisor, y0 = rect->y / divisor;
+    int x1 = (rect->x + rect->w) / divisor, y1 = (rect->y + rect->h) / divisor;
+    if (x1 > srcW / divisor) x1 = srcW / divisor;
+    if (y1 > srcH / divisor) y1 = srcH / divisor;
+    int samples = divisor * divisor;
+
+    for (int dy = y0; dy < y1; dy++) {
+        for (int dx = x0; dx < x1; dx++) {
+            Uint32 a = 0, r = 0, g = 0, b = 0;
+            for (int sy = 0; sy < divisor; sy++) {
+                const Uint32 *row = src + (size_t) (dy * divisor + sy) * srcPitch + dx * divisor;
+                for (int sx = 0; sx < divisor; sx++) {
+                    Uint32 p = row[sx];
+                    Uint32 pa = p >> 24;
+                    a += pa;
+                    r += ((p >> 16) & 0xff) * pa;
+                    g += ((p >> 8) & 0xff) * pa;
+                    b += (p & 0xff) * pa;
+                }
+            }
+            Uint32 out = 0;
+            if (a > 0) out = (a / samples) << 24 | (r / a) << 16 | (g / a) << 8 | (b / a);
+            dst[(size_t) dy * dstPitch + dx] = out;
+        }
+    }
+}
+
+//returns an ARGB8888 copy of src at the tier size, src is left untouched
+SDL_Surface *textureTierScaleSurface(SDL_Surface *src, TextureTier tier) {
+    if (!src) return NULL;
+    int divisor = textureTierDivisor(tier);
+
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(src, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!converted || divisor == 1) return converted;
+
+    int w = converted->w / divisor, h = converted->h / divisor;
+    SDL_Surface *scaled = w > 0 && h > 0 ? SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888) : NULL;
+    if (scaled && SDL_LockSurface(converted) == 0 && SDL_LockSurface(scaled) == 0) {
+        SDL_Rect all = {0, 0, converted->w, converted->h};
+        textureTierDownsample(converted->pixels, converted->w, converted->h, converted->pitch / 4, scaled->pixels,
+                              scaled->pitch / 4, &all, divisor);
+        SDL_UnlockSurface(scaled);
+        SDL_UnlockSurface(converted);
+    } else if (scaled) {
+        SDL_FreeSurface(scaled);
+        scaled = NULL;
+    }
+    SDL_FreeSurface(converted);
+    return scaled;
+}
@@ -0,0 +1,33 @@
+#ifndef TEXTURE_TIER_H
+#define TEXTURE_TIER_H
+
+#include <SDL2/SDL.h>
+
+//every texture is authored for this output size
+#define TEXTURE_SOURCE_WIDTH 1920
+#define TEXTURE_SOURCE_HEIGHT 1080
+
+//a tier is still used while the renderer stretches it by at most this much, so a 1280x720 window gets the half tier
+#define TEXTURE_TIER_MAX_UPSCALE 1.5f
+
+typedef enum {
+    TEXTURE_TIER_FULL = 0,
+    TEXTURE_TIER_HALF,
+    TEXTURE_TIER_QUARTER,
+    TEXTURE_TIER_COUNT
+} TextureTier;
+
+int textureTierDivisor(TextureTier tier);
+
+const char *textureTierName(TextureTier tier);
+
+TextureTier textureTierForOutput(int outputW, int outputH);
+
+TextureTier textureTierForRenderer(SDL_Renderer *renderer);
+
+void textureTierDownsample(const Uint32 *src, int srcW, int srcH, int srcPitch, Uint32 *dst, int dstPitch,
+                           const SDL_Rect *rect, int divisor);
+
+SDL_Surface *textureTierScaleSurface(SDL_Surface *src, TextureTier tier);
+
+#endif
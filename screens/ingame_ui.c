@@ -5,13 +5,24 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../game/hangman.h"
+#include "../game/solver.h"
 #include "../utility/utilities.h"
+#include "../utility/word_corpus.h"
 #include "graphics/texture_manager.h"
+#include "graphics/font_cache.h"
+#include "graphics/glyph_atlas.h"
+#include "graphics/text_object.h"
+#include "graphics/layer_cache.h"
 
-#define FRAME_COUNT 180
+#define FRAME_COUNT BACKGROUND_FRAME_COUNT
 #define FRAME_FPS 30.0f
 #define MAX_LIVES 6
 #define POWER_BOX_SIZE 128
+#define UI_FONT_PATH "resources/font/PixelifySans-SemiBold.ttf"
+#define UI_FONT_SIZE 36
+#define TEXT_FONT_PATH "resources/font/MotaPixel-Bold.otf"
+#define WORD_SCALE 2.15f
+#define GUESSED_SCALE 0.95f
 
 typedef struct {
     int frameCount;
@@ -22,7 +33,6 @@ typedef struct {
     int winW, winH;
 
     GameState *game;
-    TTF_Font *font;
 
     bool paused;
     bool lettersPulled;
@@ -38,72 +48,70 @@ typedef struct {
     bool showPowerResult;
     char powerResultText[256];
     float powerResultTimer;
+
+    //retained text, the geometry is only rebuilt when a string or its size changes
+    TextObject wordText;
+    float wordScale;
+    int wordBoundW;
+    unsigned long wordAtlasId;
+    TextObject hintText;
+    TextObject titleText;
+    TextObject escText;
+    TextObject enterText;
+    TextObject powerText;
+
+    //guessed letters panel, wrapped again only when the guesses or the panel width change
+    TextObject guessedHeader;
+    TextObject guessedLines[MAX_GUESSED];
+    int guessedLineCount;
+    char guessedLayout[MAX_GUESSED];
+    int guessedLayoutCount;
+    int guessedLayoutW;
+    unsigned long guessedAtlasId;
+
+    //static full screen images baked into one texture each, see overlayKey()
+    LayerCache overlayLayer;
+    LayerCache powerLayer;
 } IngameUI;
 
 static IngameUI ui;
 
 //HELPER METHODS:
 
-static bool surfacePixelOpaque(SDL_Surface *surf, int x, int y) {
-    if (!surf) return false;
-    if (x < 0 || y < 0 || x >= surf->w || y >= surf->h) return false;
-    Uint32 *pixels = (Uint32 *) surf->pixels;
-    Uint32 pixel = pixels[y * surf->w + x];
-    Uint8 r, g, b, a;
-    SDL_GetRGBA(pixel, surf->format, &r, &g, &b, &a);
-    return a > 0;
-}
-
-static void mapMouseToSurface(int mouseX, int mouseY, int winW, int winH, int surfW, int surfH, int *outX,
-                                 int *outY) {
-    if (winW <= 0) winW = 1;
-    if (winH <= 0) winH = 1;
-    *outX = mouseX * surfW / winW;
-    *outY = mouseY * surfH / winH;
-    if (*outX < 0) *outX = 0;
-    if (*outY < 0) *outY = 0;
-    if (*outX >= surfW) *outX = surfW - 1;
-    if (*outY >= surfH) *outY = surfH - 1;
+//base font for layout, fetched from the font cache every frame instead of kept in the ui struct
+static TTF_Font *uiFont(void) {
+    return fontCacheGet(UI_FONT_PATH, UI_FONT_SIZE);
 }
 
 //TEXT RENDERING:
 
-static void renderTextScaledWithShadow(SDL_Renderer *renderer, TTF_Font *font, const char *text,
-                                           int x, int y, SDL_Color color, float scale) {
-    if (!text || !font) return;
-    int baseSize = TTF_FontHeight(font);
-    int newSize = (int) (baseSize * scale);
-    if (newSize < 4) newSize = 4;
-    TTF_Font *scaledFont = TTF_OpenFont("resources/font/MotaPixel-Bold.otf", newSize);
-    if (!scaledFont) return;
+//pixel size of text drawn at scale times the base font height
+static int hudTextSize(float scale) {
+    TTF_Font *font = uiFont();
+    int size = font ? (int) (TTF_FontHeight(font) * scale) : 0;
+    return size < 4 ? 4 : size;
+}
 
+//point a retained text object at text, nothing is laid out again while text and scale stay the same
+static bool setHudText(SDL_Renderer *renderer, TextObject *object, const char *text, float scale, bool shadow) {
+    float size = (float) hudTextSize(scale);
+    GlyphAtlas *atlas = glyphAtlasGet(renderer, TEXT_FONT_PATH, size);
+    if (!text || !atlas) return false;
+    SDL_Color white = {255, 255, 255, 255};
     SDL_Color shadowColor = {0, 0, 0, 255};
-    SDL_Surface *surf = TTF_RenderText_Blended(scaledFont, text, shadowColor);
-    if (!surf) {
-        TTF_CloseFont(scaledFont);
-        return;
-    }
-    SDL_Texture *shadowTex = SDL_CreateTextureFromSurface(renderer, surf);
-    SDL_FreeSurface(surf);
-
-    surf = TTF_RenderText_Blended(scaledFont, text, color);
-    SDL_Texture *mainTex = SDL_CreateTextureFromSurface(renderer, surf);
-    SDL_FreeSurface(surf);
-
-    SDL_Rect dst;
-    dst.x = x;
-    dst.y = y;
-    SDL_QueryTexture(mainTex, NULL, NULL, &dst.w, &dst.h);
-
-    SDL_Rect shadowDst = dst;
-    shadowDst.x += 2;
-    shadowDst.y += 2;
-    SDL_RenderCopy(renderer, shadowTex, NULL, &shadowDst);
-    SDL_RenderCopy(renderer, mainTex, NULL, &dst);
-
-    SDL_DestroyTexture(shadowTex);
-    SDL_DestroyTexture(mainTex);
-    TTF_CloseFont(scaledFont);
+    textObjectSet(object, atlas, text, size, white, shadow ? &shadowColor : NULL, 2.0f);
+    return true;
+}
+
+static void drawHudText(SDL_Renderer *renderer, TextObject *object, const char *text, int x, int y, float scale) {
+    if (setHudText(renderer, object, text, scale, true)) textObjectDraw(renderer, object, (float) x, (float) y);
+}
+
+//same as drawHudText(), but centered horizontally on centerX
+static void drawHudTextCentered(SDL_Renderer *renderer, TextObject *object, const char *text, int centerX, int y,
+                                float scale) {
+    if (!setHudText(renderer, object, text, scale, true)) return;
+    textObjectDraw(renderer, object, (float) (int) (centerX - object->width / 2), (float) y);
 }
 
 // POWER UP WRAPPER FOR UI BASED
@@ -114,34 +122,23 @@ void ingameUiActivatePowerup(GameState *game, int power_id, char *outMessage, si
     char buffer[256] = {0};
 
     switch (power_id) {
-        case 1: {
-            int len = strlen(game->word);
-            int validIndexes[MAX_WORD_LEN];
-            int count = 0;
-            for (int i = 0; i < len; i++) if (game->revealed[i] == '_') validIndexes[count++] = i;
-            if (count > 0) {
-                int idx = validIndexes[rand() % count];
-                game->revealed[idx] = game->word[idx];
+        case 1: if (revealRandomBlank(game))
                 snprintf(buffer, sizeof(buffer), "Power-Up: A random letter was revealed!");
-            } else snprintf(buffer, sizeof(buffer), "Nothing happened.");
-        }
-        break;
+            else snprintf(buffer, sizeof(buffer), "Nothing happened.");
+            break;
         case 2: game->lives++;
             snprintf(buffer, sizeof(buffer), "Power-Up: +1 Life!");
             break;
-        case 3: for (int i = 0; game->word[i]; i++) {
-                char c = game->word[i];
-                if (c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u')game->revealed[i] = c;
-            }
+        case 3: revealVowels(game);
             snprintf(buffer, sizeof(buffer), "Power-Up: All vowels revealed!");
             break;
         case 4: game->shieldActive = 1;
             snprintf(buffer, sizeof(buffer), "Power-Up: Shield activated!");
             break;
         case 5: {
-            int roll = rand() % 100 + 1;
+            int roll = prngBounded(&game->rng, 100) + 1;
             if (roll <= 5) {
-                int pid = rand() % 4 + 1;
+                int pid = prngBounded(&game->rng, 4) + 1;
                 char submsg[128];
                 ingameUiActivatePowerup(game, pid, submsg, sizeof(submsg));
                 snprintf(buffer, sizeof(buffer), "Bonus random power up!\n%s", submsg);
@@ -153,6 +150,8 @@ void ingameUiActivatePowerup(GameState *game, int power_id, char *outMessage, si
             }
         }
         break;
+        case 6: snprintf(buffer, sizeof(buffer), "Power-Up: Smart hint, try '%c'!", solverSmartHint(game));
+            break;
         default: snprintf(buffer, sizeof(buffer), "Empty Box...");
     }
     strncpy(outMessage, buffer, size - 1);
@@ -175,8 +174,7 @@ bool ingameUiInit(SDL_Window *window, SDL_Renderer *renderer, GameState *game) {
     ui.lettersPulled = false;
 
     //load font
-    ui.font = TTF_OpenFont("resources/font/PixelifySans-SemiBold.ttf", 36);
-    if (!ui.font) {
+    if (!uiFont()) {
         printf("[ERROR] Failed to load font\n");
         return false;
     }
@@ -204,8 +202,20 @@ void ingameUiTriggerPowerup(void) {
 
 // destroy
 void ingameUiDestroy() {
-    //close font
-    if (ui.font) TTF_CloseFont(ui.font);
+    //fonts belong to the font cache, only the retained text geometry is owned here
+    textObjectDestroy(&ui.wordText);
+    textObjectDestroy(&ui.hintText);
+    textObjectDestroy(&ui.titleText);
+    textObjectDestroy(&ui.escText);
+    textObjectDestroy(&ui.enterText);
+    textObjectDestroy(&ui.powerText);
+    textObjectDestroy(&ui.guessedHeader);
+    for (int i = 0; i < MAX_GUESSED; i++) textObjectDestroy(&ui.guessedLines[i]);
+    ui.guessedLineCount = 0;
+    ui.guessedLayoutCount = 0;
+
+    layerCacheDestroy(&ui.overlayLayer);
+    layerCacheDestroy(&ui.powerLayer);
 }
 
 //update ui
@@ -234,11 +244,12 @@ void ingameUiHandleEvent(SDL_Event *event) {
                 ui.waitingAfterGameOver = false;
                 ui.gameOver = false;
             } else if (event->key.keysym.sym == SDLK_RETURN || event->key.keysym.sym == SDLK_KP_ENTER) {
-                char *newWordFile = getRandomWordFileName();
-                char *newWord = getRandomWordFromFile(newWordFile);
+                //the next game is drawn from the current session generator so a seeded run stays reproducible
+                Prng *rng = &ui.game->rng;
+                int category = wordCorpusRandomCategory(rng);
+                const char *newWord = wordCorpusRandomWord(category, rng);
                 if (newWord) {
-                    GameState newGame = resetGame(newWordFile, newWord, MAX_LIVES);
-                    free(newWord);
+                    GameState newGame = resetGame(wordCorpusCategoryName(category), newWord, MAX_LIVES, prngNext(rng));
                     *(ui.game) = newGame;
                 }
                 ui.gameOver = false;
@@ -250,14 +261,10 @@ void ingameUiHandleEvent(SDL_Event *event) {
     }
 
     if (event->type == SDL_MOUSEBUTTONDOWN && event->button.button == SDL_BUTTON_LEFT) {
-        SDL_Surface *surf = ui.lettersPulled ? g_ingameUITextures.lettersSurf[1] : g_ingameUITextures.lettersSurf[0];
-        if (surf) {
-            int sx, sy;
-            mapMouseToSurface(event->button.x, event->button.y, ui.winW, ui.winH, surf->w, surf->h, &sx, &sy);
-            if (surfacePixelOpaque(surf, sx, sy)) {
-                ui.lettersPulled = !ui.lettersPulled;
-                return;
-            }
+        const HitMask *mask = &g_ingameUITextures.lettersMask[ui.lettersPulled ? 1 : 0];
+        if (hitMaskTestScaled(mask, event->button.x, event->button.y, ui.winW, ui.winH)) {
+            ui.lettersPulled = !ui.lettersPulled;
+            return;
         }
     }
 
@@ -289,231 +296,249 @@ void ingameUiHandleEvent(SDL_Event *event) {
         int mx = event->button.x;
         int my = event->button.y;
 
-        for (int i = 0; i < 9; i++) {
-            SDL_Surface *surf = g_ingameUITextures.powerUI_boxSurfs[i];
-            if (surf) {
-                int sx, sy;
-                mapMouseToSurface(mx, my, ui.winW, ui.winH, surf->w, surf->h, &sx, &sy);
-                if (surfacePixelOpaque(surf, sx, sy)) {
-                    ui.selectedBox = i;
-                    ingameUiActivatePowerup(ui.game, i + 1, ui.powerResultText, sizeof(ui.powerResultText));
-                    ui.showPowerResult = true;
-                    ui.powerResultTimer = 3.0f;
-                    ui.powerUIActive = false;
-                    break;
-                }
-            }
+        //one lookup finds the box under the mouse, box i has label i + 1
+        int box = labelMapLookupScaled(&g_ingameUITextures.powerUI_boxLabels, mx, my, ui.winW, ui.winH);
+        if (box != LABEL_MAP_NONE) {
+            ui.selectedBox = box - 1;
+            ingameUiActivatePowerup(ui.game, box, ui.powerResultText, sizeof(ui.powerResultText));
+            ui.showPowerResult = true;
+            ui.powerResultTimer = 3.0f;
+            ui.powerUIActive = false;
         }
     }
 }
 
-static void renderTextFitted(SDL_Renderer *renderer, const char *text, int boundX, int boundW, int y, float baseScale,
-                               SDL_Color color) {
-    if (!text || !ui.font) return;
-    int textW, textH;
-    TTF_SizeText(ui.font, text, &textW, &textH);
-    float finalScale = baseScale;
-    float scaledW = textW * finalScale;
-    if (scaledW > boundW) {
-        finalScale = boundW / (float) textW;
-        scaledW = textW * finalScale;
+//width of text drawn at scale, measured on the master atlas it will be drawn from
+static float hudTextWidth(SDL_Renderer *renderer, const char *text, float scale) {
+    float size = (float) hudTextSize(scale);
+    GlyphAtlas *atlas = glyphAtlasGet(renderer, TEXT_FONT_PATH, size);
+    if (!atlas) return 0.0f;
+    int textW;
+    glyphAtlasMeasure(atlas, text, &textW, NULL);
+    return textW * glyphAtlasScale(atlas, size);
+}
+
+//draws the revealed word at WORD_SCALE, shrunk to fit inside the bounds
+static void renderWordFitted(SDL_Renderer *renderer, const char *text, int boundX, int boundW, int y) {
+    GlyphAtlas *atlas = glyphAtlasGet(renderer, TEXT_FONT_PATH, (float) hudTextSize(WORD_SCALE));
+    if (!text || !atlas) return;
+
+    //the fit only has to be measured again when the word or the bounds change
+    if (boundW != ui.wordBoundW || ui.wordAtlasId != atlas->id ||
+        strncmp(ui.wordText.text, text, sizeof(ui.wordText.text) - 1) != 0) {
+        float width = hudTextWidth(renderer, text, WORD_SCALE);
+        ui.wordScale = width > boundW ? WORD_SCALE * boundW / width : WORD_SCALE;
+        //a shrunk word can fall into a smaller master whose hinted advances differ a little, fit it again there
+        width = hudTextWidth(renderer, text, ui.wordScale);
+        if (width > boundW) ui.wordScale *= boundW / width;
+        ui.wordBoundW = boundW;
+        ui.wordAtlasId = atlas->id;
     }
-    int baseSize = TTF_FontHeight(ui.font);
-    int dynSize = (int) (baseSize * finalScale);
-    if (dynSize < 4) dynSize = 4;
-    TTF_Font *f = TTF_OpenFont("resources/font/MotaPixel-Bold.otf", dynSize);
-    if (!f) return;
-    SDL_Surface *surf = TTF_RenderText_Blended(f, text, color);
-    TTF_CloseFont(f);
-    if (!surf) return;
-    SDL_Texture *tex = SDL_CreateTextureFromSurface(renderer, surf);
-    SDL_FreeSurface(surf);
-    if (!tex) return;
-    SDL_Rect dst;
-    dst.w = (int) scaledW;
-    dst.h = dynSize;
-    dst.x = boundX + (boundW - dst.w) / 2;
-    dst.y = y;
-    SDL_RenderCopy(renderer, tex, NULL, &dst);
-    SDL_DestroyTexture(tex);
+
+    if (!setHudText(renderer, &ui.wordText, text, ui.wordScale, false)) return;
+    textObjectDraw(renderer, &ui.wordText, (float) (int) (boundX + (boundW - ui.wordText.width) / 2), (float) y);
 }
 
-//render
-void ingameUiRender(SDL_Renderer *renderer, SDL_Window *window) {
-    SDL_GetWindowSize(window, &ui.winW, &ui.winH);
-    SDL_RenderClear(renderer);
+//wraps the guessed letters into lines no wider than boundW
+static void layoutGuessedLines(SDL_Renderer *renderer, const GlyphAtlas *atlas, int boundW) {
+    float scale = glyphAtlasScale(atlas, (float) hudTextSize(GUESSED_SCALE));
+    char line[TEXT_OBJECT_MAX_LEN] = {0};
+    int lineLen = 0;
+    int count = 0;
 
-    //background frames
-    if (g_ingameUITextures.frames[ui.currentFrame]) {
-        SDL_Rect full = {0, 0, ui.winW, ui.winH};
-        SDL_RenderCopy(renderer, g_ingameUITextures.frames[ui.currentFrame], NULL, &full);
-    }
+    for (int i = 0; i < ui.game->numGuessed; ++i) {
+        char c = ui.game->guessed[i];
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "%c%s", c, (i < ui.game->numGuessed - 1) ? ", " : "");
 
-    //lives overlay
-    if (ui.game) {
-        int lives = ui.game->lives;
-        if (lives < 0) lives = 0;
-        if (lives > MAX_LIVES) lives = MAX_LIVES;
+        char tempLine[TEXT_OBJECT_MAX_LEN];
+        snprintf(tempLine, sizeof(tempLine), "%s%s", line, buffer);
 
-        SDL_Texture *livesTex = g_ingameUITextures.livesTextures[lives];
-        if (livesTex) {
-            SDL_Rect r = {0, 0, ui.winW, ui.winH};
-            SDL_RenderCopy(renderer, livesTex, NULL, &r);
+        int textW, textH;
+        glyphAtlasMeasure(atlas, tempLine, &textW, &textH);
+        if (textW * scale > boundW && lineLen > 0) {
+            setHudText(renderer, &ui.guessedLines[count++], line, GUESSED_SCALE, true);
+            snprintf(line, sizeof(line), "%s", buffer);
+            lineLen = strlen(buffer);
+        } else {
+            snprintf(line, sizeof(line), "%s", tempLine);
+            lineLen += strlen(buffer);
         }
+    }
+    if (lineLen > 0) setHudText(renderer, &ui.guessedLines[count++], line, GUESSED_SCALE, true);
 
-        SDL_Color white = {255, 255, 255, 255};
-
-        //fit revealed word inside the reference area (based on 1080p)
-        float leftPercent = 562.0f / 1920.0f;
-        float rightPercent = 690.0f / 1920.0f;
-        int boundX = (int) (ui.winW * leftPercent);
-        int boundW = ui.winW - (int) (ui.winW * leftPercent) - (int) (ui.winW * rightPercent);
-        int y = (int) (ui.winH * 0.4);
-
-        renderTextFitted(renderer, ui.game->revealed, boundX, boundW, y, 2.15f, white);
-
-        //word category hint
-        int xHint = (int)(ui.winW * 0.02f);
-        int yHint = (int)(ui.winH * 0.25f);
-        char hintString[256] = "Hint: ";
-        snprintf(hintString, sizeof(hintString), "Hint: %s", ui.game->wordFile);
-        renderTextScaledWithShadow(renderer, ui.font, hintString,
-                                       xHint, yHint, white, 1.0f);
-
-        //game over you won message
-        bool gameOver = (ui.game->lives == 0 || isWordFullyRevealed(ui.game->revealed));
-        if (gameOver) {
-            ui.gameOver = true;
-            ui.waitingAfterGameOver = true;
-
-            const char *escLine = "[ESC] to quit";
-            const char *enterLine = "[Enter] to play again";
-
-            int textW, textH;
-            int spacing = 8;
-
-            //winning message
-            if (ui.game->lives > 0) {
-                const char *title = "YOU WON";
-                int titleY = (int) (ui.winH * 0.10f);
-                TTF_SizeText(ui.font, title, &textW, &textH);
-                int centerX = (ui.winW - 2 * (textW)) / 2;
-                renderTextScaledWithShadow(renderer, ui.font, title, centerX, titleY, white, 2.0f);
-            } else {
-                char title[256];  //a writable buffer
-                snprintf(title, sizeof(title), "Word was: %s", ui.game->word);
+    ui.guessedLineCount = count;
+    memcpy(ui.guessedLayout, ui.game->guessed, sizeof(ui.guessedLayout));
+    ui.guessedLayoutCount = ui.game->numGuessed;
+    ui.guessedLayoutW = boundW;
+    ui.guessedAtlasId = atlas->id;
+}
 
-                int titleY = (int)(ui.winH * 0.30f);
-                TTF_SizeText(ui.font, title, &textW, &textH);
-                int centerX = (ui.winW - 2 * textW) / 1.5;
-                renderTextScaledWithShadow(renderer, ui.font, title, centerX, titleY, white, 1.5f);
-            }
+static int clampedLives(void) {
+    int lives = ui.game->lives;
+    if (lives < 0) lives = 0;
+    if (lives > MAX_LIVES) lives = MAX_LIVES;
+    return lives;
+}
+
+//everything the overlay layer shows, while paused the text under the pause menu is baked in as well
+//a paused game takes no guesses, so the text can only change after it is unpaused
+static Uint64 overlayKey(void) {
+    Uint64 key = (Uint64) textureManagerGetTier();
+    key |= (Uint64) ui.lettersPulled << 4;
+    key |= (Uint64) ui.paused << 5;
+    if (ui.game) key |= (Uint64) (clampedLives() + 1) << 8;
+    if (ui.game && ui.paused) key |= (Uint64) ui.game->numGuessed << 16;
+    return key;
+}
 
+static void drawLivesOverlay(SDL_Renderer *renderer, const SDL_Rect *full) {
+    if (!ui.game) return;
+    SDL_Texture *livesTex = g_ingameUITextures.livesTextures[clampedLives()];
+    if (livesTex) SDL_RenderCopy(renderer, livesTex, NULL, full);
+}
+
+//revealed word, hint and the game over prompts
+static void drawGameText(SDL_Renderer *renderer) {
+    if (!ui.game) return;
 
-            //ESC/ENTER prompts
-            int bottomY = (int) (ui.winH * 0.75);
+    //fit revealed word inside the reference area (based on 1080p)
+    float leftPercent = 562.0f / 1920.0f;
+    float rightPercent = 690.0f / 1920.0f;
+    int boundX = (int) (ui.winW * leftPercent);
+    int boundW = ui.winW - (int) (ui.winW * leftPercent) - (int) (ui.winW * rightPercent);
+    int y = (int) (ui.winH * 0.4);
+
+    renderWordFitted(renderer, ui.game->revealed, boundX, boundW, y);
+
+    //word category hint
+    int xHint = (int)(ui.winW * 0.02f);
+    int yHint = (int)(ui.winH * 0.25f);
+    char hintString[256] = "Hint: ";
+    snprintf(hintString, sizeof(hintString), "Hint: %s", ui.game->wordFile);
+    drawHudText(renderer, &ui.hintText, hintString, xHint, yHint, 1.0f);
+
+    //game over you won message
+    bool gameOver = (ui.game->lives == 0 || isGameWon(ui.game));
+    if (gameOver) {
+        ui.gameOver = true;
+        ui.waitingAfterGameOver = true;
+
+        const char *escLine = "[ESC] to quit";
+        const char *enterLine = "[Enter] to play again";
+
+        int spacing = 8;
+
+        //winning message
+        if (ui.game->lives > 0) {
+            int titleY = (int) (ui.winH * 0.10f);
+            drawHudTextCentered(renderer, &ui.titleText, "YOU WON", ui.winW / 2, titleY, 2.0f);
+        } else {
+            char title[256];  //a writable buffer
+            snprintf(title, sizeof(title), "Word was: %s", ui.game->word);
+
+            int titleY = (int)(ui.winH * 0.30f);
+            drawHudTextCentered(renderer, &ui.titleText, title, ui.winW / 2, titleY, 1.5f);
+        }
 
-            TTF_SizeText(ui.font, escLine, &textW, &textH);
-            int escX = (ui.winW - textW) / 2;
-            int escY = bottomY - (textH * 2 + spacing);
-            renderTextScaledWithShadow(renderer, ui.font, escLine, escX, escY, white, 1.0f);
 
-            TTF_SizeText(ui.font, enterLine, &textW, &textH);
-            int enterX = (ui.winW - textW) / 2;
-            int enterY = escY + textH + spacing;
-            renderTextScaledWithShadow(renderer, ui.font, enterLine, enterX, enterY, white, 1.0f);
+        //ESC/ENTER prompts, stacked upwards from bottomY
+        int bottomY = (int) (ui.winH * 0.75);
+        if (setHudText(renderer, &ui.escText, escLine, 1.0f, true) &&
+            setHudText(renderer, &ui.enterText, enterLine, 1.0f, true)) {
+            int escY = bottomY - (int) (ui.escText.height + ui.enterText.height) - spacing;
+            int enterY = escY + (int) ui.escText.height + spacing;
+            drawHudTextCentered(renderer, &ui.escText, escLine, ui.winW / 2, escY, 1.0f);
+            drawHudTextCentered(renderer, &ui.enterText, enterLine, ui.winW / 2, enterY, 1.0f);
         }
     }
+}
 
-    //letters used button
+static void drawLettersButton(SDL_Renderer *renderer, const SDL_Rect *full) {
     SDL_Texture *buttonTex = ui.lettersPulled ? g_ingameUITextures.lettersTex[1] : g_ingameUITextures.lettersTex[0];
-    if (buttonTex) {
-        SDL_Rect full = {0, 0, ui.winW, ui.winH};
-        SDL_RenderCopy(renderer, buttonTex, NULL, &full);
-    }
+    if (buttonTex) SDL_RenderCopy(renderer, buttonTex, NULL, full);
+}
 
-    //guessed letters
-    if (ui.lettersPulled && ui.game) {
-        SDL_Color white = {255, 255, 255, 255};
+static void drawGuessedLetters(SDL_Renderer *renderer) {
+    GlyphAtlas *textAtlas = glyphAtlasGet(renderer, TEXT_FONT_PATH, (float) hudTextSize(GUESSED_SCALE));
+    if (!ui.lettersPulled || !ui.game || !textAtlas) return;
 
-        int boundX = (int) (ui.winW * (1580.0f / 1920.0f));
-        int boundW = ui.winW - boundX;
-        int boundY = (int) (ui.winH * (218.0f / 1080.0f));
+    int boundX = (int) (ui.winW * (1580.0f / 1920.0f));
+    int boundW = ui.winW - boundX;
+    int boundY = (int) (ui.winH * (218.0f / 1080.0f));
+    int centerX = boundX + boundW / 2;
 
-        int textW, textH;
-        TTF_SizeText(ui.font, "guessed:", &textW, &textH);
-        int centerX = boundX + (boundW - textW) / 2;
-        renderTextScaledWithShadow(renderer, ui.font, "guessed:", centerX, boundY, white, 0.95f);
-
-        char line[1024] = {0};
-        int lineLen = 0;
-        int yOffset = textH + 4;
-        int curY = boundY + yOffset;
-
-        for (int i = 0; i < ui.game->numGuessed; ++i) {
-            char c = ui.game->guessed[i];
-            char buffer[8];
-            snprintf(buffer, sizeof(buffer), "%c%s", c, (i < ui.game->numGuessed - 1) ? ", " : "");
-
-            char tempLine[1024];
-            snprintf(tempLine, sizeof(tempLine), "%s%s", line, buffer);
-
-            TTF_SizeText(ui.font, tempLine, &textW, &textH);
-            if (textW > boundW && lineLen > 0) {
-                TTF_SizeText(ui.font, line, &textW, &textH);
-                centerX = boundX + (boundW - textW) / 2;
-                renderTextScaledWithShadow(renderer, ui.font, line, centerX, curY, white, 0.95f);
-                curY += textH + 2;
-                snprintf(line, sizeof(line), "%s", buffer);
-                lineLen = strlen(buffer);
-            } else {
-                snprintf(line, sizeof(line), "%s", tempLine);
-                lineLen += strlen(buffer);
-            }
-        }
+    drawHudTextCentered(renderer, &ui.guessedHeader, "guessed:", centerX, boundY, GUESSED_SCALE);
 
-        if (lineLen > 0) {
-            TTF_SizeText(ui.font, line, &textW, &textH);
-            centerX = boundX + (boundW - textW) / 2;
-            renderTextScaledWithShadow(renderer, ui.font, line, centerX, curY, white, 0.95f);
+    if (ui.game->numGuessed != ui.guessedLayoutCount || boundW != ui.guessedLayoutW ||
+        textAtlas->id != ui.guessedAtlasId || memcmp(ui.guessedLayout, ui.game->guessed, ui.game->numGuessed) != 0) {
+        layoutGuessedLines(renderer, textAtlas, boundW);
+    }
+
+    float curY = boundY + ui.guessedHeader.height + 4;
+    for (int i = 0; i < ui.guessedLineCount; i++) {
+        TextObject *line = &ui.guessedLines[i];
+        textObjectDraw(renderer, line, (float) (int) (centerX - line->width / 2), (float) (int) curY);
+        curY += line->height + 2;
+    }
+}
+
+//render
+void ingameUiRender(SDL_Renderer *renderer, SDL_Window *window) {
+    SDL_GetWindowSize(window, &ui.winW, &ui.winH);
+    SDL_RenderClear(renderer);
+    SDL_Rect full = {0, 0, ui.winW, ui.winH};
+
+    //background frames, streamed a few frames ahead by the decoder thread
+    SDL_Texture *frameTex = animStreamFrame(&g_ingameUITextures.background, renderer, ui.currentFrame);
+    if (frameTex) SDL_RenderCopy(renderer, frameTex, NULL, &full);
+
+    //lives, letters button and pause menu go on screen as one blit, baked again only when one of them changes
+    bool paused = ui.paused && g_ingameUITextures.pauseTex;
+    if (layerCacheBegin(&ui.overlayLayer, renderer, ui.winW, ui.winH, overlayKey())) {
+        drawLivesOverlay(renderer, &full);
+        if (paused) drawGameText(renderer);
+        drawLettersButton(renderer, &full);
+        if (paused) {
+            drawGuessedLetters(renderer);
+            SDL_RenderCopy(renderer, g_ingameUITextures.pauseTex, NULL, &full);
         }
     }
+    layerCacheEnd(&ui.overlayLayer, renderer, &full);
 
-    //pause overlay
-    if (ui.paused && g_ingameUITextures.pauseTex) {
-        SDL_Rect full = {0, 0, ui.winW, ui.winH};
-        SDL_RenderCopy(renderer, g_ingameUITextures.pauseTex, NULL, &full);
+    //text sits above the letters button here, the two never overlap
+    if (!paused) {
+        drawGameText(renderer);
+        drawGuessedLetters(renderer);
     }
 
-    //power ui
+    //power ui, the dimming, panel and all nine boxes only change with the window size
     if (ui.powerUIActive) {
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 150);
-        SDL_Rect full = {0, 0, ui.winW, ui.winH};
-        SDL_RenderFillRect(renderer, &full);
+        if (layerCacheBegin(&ui.powerLayer, renderer, ui.winW, ui.winH, (Uint64) textureManagerGetTier())) {
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 150);
+            SDL_RenderFillRect(renderer, &full);
 
-        if (g_ingameUITextures.powerUI_bg) SDL_RenderCopy(renderer, g_ingameUITextures.powerUI_bg, NULL, &full);
+            if (g_ingameUITextures.powerUI_bg) SDL_RenderCopy(renderer, g_ingameUITextures.powerUI_bg, NULL, &full);
 
-        for (int i = 0; i < 9; i++) {
-            if (g_ingameUITextures.powerUI_boxes[i])
-                SDL_RenderCopy(renderer, g_ingameUITextures.powerUI_boxes[i], NULL, &full);
+            for (int i = 0; i < 9; i++) {
+                if (g_ingameUITextures.powerUI_boxes[i])
+                    SDL_RenderCopy(renderer, g_ingameUITextures.powerUI_boxes[i], NULL, &full);
+            }
         }
+        layerCacheEnd(&ui.powerLayer, renderer, &full);
     }
 
     //power result text
     if (ui.showPowerResult) {
         SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 100);
-        SDL_Rect full = {0, 0, ui.winW, ui.winH};
         SDL_RenderFillRect(renderer, &full);
 
-        SDL_Color white = {255, 255, 255, 255};
-
-        int textW, textH;
-        if (TTF_SizeText(ui.font, ui.powerResultText, &textW, &textH) == 0) {
-            int x = (ui.winW - textW) / 2;
-            int y = (ui.winH - textH) / 2;
-            renderTextScaledWithShadow(renderer, ui.font, ui.powerResultText, x, y, white, 1.5f);
+        if (setHudText(renderer, &ui.powerText, ui.powerResultText, 1.5f, true)) {
+            int x = (int) (ui.winW - ui.powerText.width) / 2;
+            int y = (int) (ui.winH - ui.powerText.height) / 2;
+            textObjectDraw(renderer, &ui.powerText, (float) x, (float) y);
         }
     }
 
@@ -528,6 +553,11 @@ bool ingameUiIsGameOver(void) {
     return ui.gameOver;
 }
 
+//the background only advances while unpaused, a paused game is a static screen
+bool ingameUiIsAnimating(void) {
+    return !ui.paused;
+}
+
 bool ingameUiShouldQuit(void) {
     return ui.quitToMenu;
 }
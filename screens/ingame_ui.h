@@ -19,6 +19,8 @@ bool ingameUiIsWaitingAfterGameover(void);
 
 bool ingameUiIsGameOver(void);
 
+bool ingameUiIsAnimating(void);
+
 void setShouldQuit(bool b);
 
 bool ingameUiShouldQuit(void);
@@ -2,13 +2,22 @@
 #include <SDL2/SDL_ttf.h>
 #include <stdio.h>
 
-static TTF_Font *g_loadingFont = NULL;
+#include "graphics/font_cache.h"
+#include "graphics/glyph_atlas.h"
+#include "graphics/text_object.h"
+
+#define LOADING_FONT_PATH "resources/font/PixelifySans-Bold.ttf"
+#define LOADING_FONT_SIZE 48
+
 static SDL_Color g_textColor = {255, 255, 255, 255};
 
+//the title never changes and the percentage only changes when progress crosses a whole percent
+static TextObject g_titleText;
+static TextObject g_percentText;
+
 bool loadingScreenInit(SDL_Window *window, SDL_Renderer *renderer) {
-    //load a font for "Loading..." text
-    g_loadingFont = TTF_OpenFont("resources/font/PixelifySans-Bold.ttf", 48);
-    if (!g_loadingFont) {
+    //rasterize the face for "Loading..." text once, up front
+    if (!glyphAtlasGet(renderer, LOADING_FONT_PATH, LOADING_FONT_SIZE)) {
         printf("[WARNING] Failed to load font for loading screen: %s\n", TTF_GetError());
         //continue anyway, we can still show progress bar
     }
@@ -19,27 +28,17 @@ void loadingScreenRender(SDL_Renderer *renderer, SDL_Window *window, float progr
     int windowW, windowH;
     SDL_GetWindowSize(window, &windowW, &windowH);
 
+    GlyphAtlas *atlas = glyphAtlasGet(renderer, LOADING_FONT_PATH, LOADING_FONT_SIZE);
+
     // Clear to dark background
     SDL_SetRenderDrawColor(renderer, 20, 20, 30, 255);
     SDL_RenderClear(renderer);
 
     //draw "Loading..." text
-    if (g_loadingFont) {
-        SDL_Surface *textSurf = TTF_RenderText_Blended(g_loadingFont, "Loading...", g_textColor);
-        if (textSurf) {
-            SDL_Texture *textTex = SDL_CreateTextureFromSurface(renderer, textSurf);
-            if (textTex) {
-                SDL_Rect textRect = {
-                    windowW / 2 - textSurf->w / 2,
-                    windowH / 2 - 80,
-                    textSurf->w,
-                    textSurf->h
-                };
-                SDL_RenderCopy(renderer, textTex, NULL, &textRect);
-                SDL_DestroyTexture(textTex);
-            }
-            SDL_FreeSurface(textSurf);
-        }
+    if (atlas) {
+        textObjectSet(&g_titleText, atlas, "Loading...", LOADING_FONT_SIZE, g_textColor, NULL, 0.0f);
+        textObjectDraw(renderer, &g_titleText, (float) (windowW / 2 - (int) g_titleText.width / 2),
+                       (float) (windowH / 2 - 80));
     }
 
     //draw progress bar background
@@ -65,33 +64,20 @@ void loadingScreenRender(SDL_Renderer *renderer, SDL_Window *window, float progr
     }
 
     //draw percentage text
-    if (g_loadingFont) {
+    if (atlas) {
         char percentText[32];
         snprintf(percentText, sizeof(percentText), "%.0f%%", progress * 100.0f);
-        
-        SDL_Surface *percentSurf = TTF_RenderText_Blended(g_loadingFont, percentText, g_textColor);
-        if (percentSurf) {
-            SDL_Texture *percentTex = SDL_CreateTextureFromSurface(renderer, percentSurf);
-            if (percentTex) {
-                SDL_Rect percentRect = {
-                    windowW / 2 - percentSurf->w / 2,
-                    windowH / 2 + 50,
-                    percentSurf->w,
-                    percentSurf->h
-                };
-                SDL_RenderCopy(renderer, percentTex, NULL, &percentRect);
-                SDL_DestroyTexture(percentTex);
-            }
-            SDL_FreeSurface(percentSurf);
-        }
+
+        textObjectSet(&g_percentText, atlas, percentText, LOADING_FONT_SIZE, g_textColor, NULL, 0.0f);
+        textObjectDraw(renderer, &g_percentText, (float) (windowW / 2 - (int) g_percentText.width / 2),
+                       (float) (windowH / 2 + 50));
     }
 
     SDL_RenderPresent(renderer);
 }
 
 void loadingScreenDestroy(void) {
-    if (g_loadingFont) {
-        TTF_CloseFont(g_loadingFont);
-        g_loadingFont = NULL;
-    }
-}
\ No newline at end of file
+    //the glyphs belong to the glyph atlas cache, only the text geometry is owned here
+    textObjectDestroy(&g_titleText);
+    textObjectDestroy(&g_percentText);
+}
@@ -11,22 +11,6 @@ typedef struct {
 
 static MainMenu menu;
 
-//check if mouse hovers over image, pixel perfect
-static bool isMouseOver(SDL_Surface *surf, int mouseX, int mouseY) {
-    if (!surf) return false;
-
-    if (mouseX < 0 || mouseY < 0 || mouseX >= surf->w || mouseY >= surf->h)
-        return false;
-
-    Uint32 *pixels = (Uint32 *) surf->pixels;
-    Uint32 pixel = pixels[mouseY * surf->w + mouseX];
-
-    Uint8 r, g, b, a;
-    SDL_GetRGBA(pixel, surf->format, &r, &g, &b, &a);
-
-    return a > 0;
-}
-
 //maps mouse coordinates to image relative to 1080p
 static void mapMouseToImage(int mouseX, int mouseY, int winW, int winH, int *outX, int *outY) {
     *outX = mouseX * 1920 / winW;
@@ -65,9 +49,10 @@ MenuAction mainMenuHandleEvent(SDL_Window *window, SDL_Renderer *renderer, SDL_E
     }
 
     if (e->type == SDL_MOUSEBUTTONDOWN && e->button.button == SDL_BUTTON_LEFT) {
-        if (isMouseOver(g_mainMenuTextures.startSurface, menu.mouseX, menu.mouseY))
+        int button = labelMapLookup(&g_mainMenuTextures.buttons, menu.mouseX, menu.mouseY);
+        if (button == MAIN_MENU_LABEL_START)
             return MENU_START;
-        if (isMouseOver(g_mainMenuTextures.aboutSurface, menu.mouseX, menu.mouseY))
+        if (button == MAIN_MENU_LABEL_ABOUT)
             return MENU_ABOUT;
     }
 
@@ -90,12 +75,14 @@ void mainMenuRender(SDL_Renderer *renderer, SDL_Window *window) {
     SDL_Rect fullWin = {0, 0, menu.winW, menu.winH};
     SDL_RenderCopy(renderer, g_mainMenuTextures.background, NULL, &fullWin);
 
-    if (isMouseOver(g_mainMenuTextures.startSurface, menu.mouseX, menu.mouseY))
+    int hovered = labelMapLookup(&g_mainMenuTextures.buttons, menu.mouseX, menu.mouseY);
+
+    if (hovered == MAIN_MENU_LABEL_START)
         SDL_RenderCopy(renderer, g_mainMenuTextures.startHover, NULL, &fullWin);
     else
         SDL_RenderCopy(renderer, g_mainMenuTextures.start, NULL, &fullWin);
 
-    if (isMouseOver(g_mainMenuTextures.aboutSurface, menu.mouseX, menu.mouseY))
+    if (hovered == MAIN_MENU_LABEL_ABOUT)
         SDL_RenderCopy(renderer, g_mainMenuTextures.aboutHover, NULL, &fullWin);
     else
         SDL_RenderCopy(renderer, g_mainMenuTextures.about, NULL, &fullWin);
@@ -1,17 +1,46 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
 
 #include "game/hangman.h"
+#include "game/solver.h"
 #include "utility/utilities.h"
+#include "utility/word_corpus.h"
 
-int main() {
-    srand(time(NULL));
+//pass a seed as the first argument to replay the same game
+//and easy, medium or hard as the second to pick the word from a difficulty band
+//--evil anywhere plays evil hangman, where the word keeps changing to dodge the guesses
+int main(int argc, char *argv[]) {
+    bool evilMode = false;
+    const char *args[2] = {NULL, NULL};
+    int argCount = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--evil") == 0) evilMode = true;
+        else if (argCount < 2) args[argCount++] = argv[i];
+    }
+
+    uint64_t seed = args[0] ? strtoull(args[0], NULL, 10) : prngEntropySeed();
+    int band = -1;
+    if (args[1]) {
+        const char *bandNames[DIFFICULTY_BAND_COUNT] = {"easy", "medium", "hard"};
+        for (int i = 0; i < DIFFICULTY_BAND_COUNT; i++) {
+            if (strcmp(args[1], bandNames[i]) == 0) band = i;
+        }
+    }
+    Prng rng;
+    prngSeed(&rng, seed);
 
-    //get random word file name, and a random word from that file
-    char *wordFile = getRandomWordFileName();
-    char *word = getRandomWordFromFile(wordFile);
+    //load the word lists, then pick a random category and a random word from it
+    if (!wordCorpusInit()) {
+        printf("Failed to load words.\n");
+        return 1;
+    }
+    solverHintInit(wordCorpusDictionary());
+
+    int category = wordCorpusRandomCategory(&rng);
+    const char *word = band >= 0 ? wordCorpusRandomWordInBand(category, (DifficultyBand) band, &rng)
+                                 : wordCorpusRandomWord(category, &rng);
 
     if (!word) {
         printf("Failed to load word.\n");
@@ -19,7 +48,13 @@ int main() {
     }
 
     //initialise game state
-    GameState game = initHangman(wordFile, word, 6);
+    GameState game;
+    EvilHangman evil;
+    if (evilMode) {
+        game = initEvilHangman(&evil, wordCorpusDictionary(), category, word, 6, prngNext(&rng));
+    } else {
+        game = initHangman(wordCorpusCategoryName(category), word, 6, prngNext(&rng));
+    }
 
     printf("test hangman:\n");
 
@@ -29,6 +64,7 @@ int main() {
         printf("Word: %s\n", game.revealed);
         printf("Lives: %d\n", game.lives);
         printf("Guessed: %s\n", game.guessed);
+        if (game.evil) printf("Candidates: %u\n", evilHangmanCandidateCount(&game));
 
         //user guesses character here
         printf("Enter guess: ");
@@ -52,11 +88,13 @@ int main() {
         //check if player won
         if (isGameWon(&game)) {
             printf("You won! Word: %s\n", game.word);
+            if (game.evil) evilHangmanDestroy(game.evil);
             return 0;
         }
     }
 
     printf("Game over! Word was: %s\n", game.word);
+    if (game.evil) evilHangmanDestroy(game.evil);
 
     return 0;
 }
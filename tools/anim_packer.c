@@ -0,0 +1,163 @@
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../utility/anim_file.h"
+
+//loads a frame as packed ARGB rows, the converted surface may pad its rows and the writer wants them packed
+static uint32_t *loadFrame(const char *path, int *width, int *height) {
+    SDL_Surface *loaded = IMG_Load(path);
+    SDL_Surface *frame = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0) : NULL;
+    if (loaded) SDL_FreeSurface(loaded);
+    if (!frame) {
+        printf("[ERROR] Failed to load frame %s: %s\n", path, IMG_GetError());
+        return NULL;
+    }
+
+    uint32_t *pixels = malloc((size_t) frame->w * frame->h * sizeof(uint32_t));
+    if (pixels && SDL_LockSurface(frame) == 0) {
+        for (int y = 0; y < frame->h; y++) {
+            memcpy(pixels + (size_t) y * frame->w, (const uint8_t *) frame->pixels + (size_t) y * frame->pitch,
+                   (size_t) frame->w * sizeof(uint32_t));
+        }
+        SDL_UnlockSurface(frame);
+    } else {
+        printf("[ERROR] Failed to read frame %s\n", path);
+        free(pixels);
+        pixels = NULL;
+    }
+    *width = frame->w;
+    *height = frame->h;
+    SDL_FreeSurface(frame);
+    return pixels;
+}
+
+//replays every record of the written file onto a canvas and compares it with the source frames, the loop record
+//has to turn the last frame back into the first, only the first frame is kept in memory besides the canvas
+static bool verifyPacked(const AnimFile *anim, char *paths[], uint32_t frameCount) {
+    int width = (int) anim->header->width, height = (int) anim->header->height;
+    size_t frameBytes = (size_t) width * height * sizeof(uint32_t);
+    uint32_t *canvas = calloc(1, frameBytes);
+    uint32_t *first = NULL;
+    bool ok = canvas != NULL;
+
+    for (uint32_t i = 0; ok && i <= frameCount; i++) {
+        //the last record loops back, so it is checked against the first frame
+        const char *path = paths[i % frameCount];
+        if (!animFileApplyFrame(anim, i, canvas, NULL)) {
+            printf("[ERROR] Record %u does not decode\n", i);
+            ok = false;
+            break;
+        }
+
+        uint32_t *source = first;
+        if (i < frameCount) {
+            int w, h;
+            source = loadFrame(path, &w, &h);
+            if (!source || w != width || h != height) {
+                if (source) printf("[ERROR] Frame %s changed size while packing\n", path);
+                free(source);
+                ok = false;
+                break;
+            }
+        }
+        if (memcmp(canvas, source, frameBytes) != 0) {
+            printf("[ERROR] Record %u does not reproduce %s\n", i, path);
+            ok = false;
+        }
+        if (i == 0) {
+            first = source;
+        } else if (source != first) {
+            free(source);
+        }
+    }
+    free(first);
+    free(canvas);
+    return ok;
+}
+
+//packs numbered animation frames into one keyframe plus tile deltas, the game streams the result
+//usage: anim_packer <output.hanim> <frame.png>...   frames are taken in the order given
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("usage: %s <output.hanim> <frame.png>...\n", argv[0]);
+        return 1;
+    }
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
+        printf("[ERROR] SDL_image init failed: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    uint32_t frameCount = (uint32_t) (argc - 2);
+    AnimWriter writer = {0};
+    bool started = false;
+    int width = 0, height = 0;
+    uint64_t sourceBytes = 0;
+
+    for (uint32_t i = 0; i < frameCount; i++) {
+        const char *path = argv[i + 2];
+        int w, h;
+        uint32_t *pixels = loadFrame(path, &w, &h);
+        if (!pixels) {
+            animWriterAbort(&writer);
+            return 1;
+        }
+
+        if (!started) {
+            width = w;
+            height = h;
+            started = animWriterBegin(&writer, argv[1], (uint32_t) width, (uint32_t) height, frameCount);
+            if (!started) {
+                printf("[ERROR] Failed to start %s\n", argv[1]);
+                free(pixels);
+                return 1;
+            }
+        } else if (w != width || h != height) {
+            printf("[ERROR] Frame %s is %dx%d, expected %dx%d\n", path, w, h, width, height);
+            free(pixels);
+            animWriterAbort(&writer);
+            return 1;
+        }
+
+        bool ok = animWriterAddFrame(&writer, pixels);
+        free(pixels);
+        if (!ok) {
+            printf("[ERROR] Failed to write frame %s\n", path);
+            animWriterAbort(&writer);
+            return 1;
+        }
+        sourceBytes += (uint64_t) width * height * sizeof(uint32_t);
+    }
+
+    uint64_t tilesWritten = writer.tilesWritten;
+    uint64_t tilesPerFrame = (uint64_t) writer.header.tilesX * writer.header.tilesY;
+    if (!animWriterFinish(&writer)) {
+        printf("[ERROR] Failed to finish %s\n", argv[1]);
+        return 1;
+    }
+
+    AnimFile anim;
+    if (!animFileOpen(&anim, argv[1])) {
+        printf("[ERROR] %s does not read back\n", argv[1]);
+        return 1;
+    }
+    if (!verifyPacked(&anim, argv + 2, frameCount)) {
+        printf("[ERROR] %s does not decode back to its frames\n", argv[1]);
+        animFileClose(&anim);
+        remove(argv[1]);
+        return 1;
+    }
+    printf("Packed %u frames of %dx%d into %s (%u bytes, %.1f%% of raw pixels)\n",
+           frameCount, width, height, argv[1], anim.header->fileSize, 100.0 * anim.header->fileSize / sourceBytes);
+    if (frameCount > 1) {
+        printf("Changed tiles per frame: %.1f of %llu\n", (double) (tilesWritten - tilesPerFrame) / (frameCount - 1),
+               (unsigned long long) tilesPerFrame);
+    }
+    animFileClose(&anim);
+
+    IMG_Quit();
+    return 0;
+}
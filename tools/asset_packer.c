@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../utility/asset_pack.h"
+
+//packs resource files into one asset pack, run it from the directory the game runs from
+//every asset is named by its path as given, with '/' separators, which is the path the game asks for
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("usage: %s <output.pak> <file>...\n", argv[0]);
+        return 1;
+    }
+
+    int count = argc - 2;
+    AssetPackSource *sources = malloc(count * sizeof(AssetPackSource));
+    char **names = malloc(count * sizeof(char *));
+    if (!sources || !names) return 1;
+
+    for (int i = 0; i < count; i++) {
+        const char *path = argv[i + 2];
+        while (path[0] == '.' && (path[1] == '/' || path[1] == '\\')) path += 2;
+
+        names[i] = malloc(strlen(path) + 1);
+        if (!names[i]) return 1;
+        for (size_t c = 0; c <= strlen(path); c++) names[i][c] = path[c] == '\\' ? '/' : path[c];
+
+        sources[i].name = names[i];
+        sources[i].path = argv[i + 2];
+    }
+
+    if (!assetPackWrite(argv[1], sources, count)) {
+        printf("[ERROR] Failed to write %s\n", argv[1]);
+        return 1;
+    }
+
+    AssetPack pack;
+    if (!assetPackOpen(&pack, argv[1])) {
+        printf("[ERROR] Failed to read back %s\n", argv[1]);
+        return 1;
+    }
+    printf("Packed %u assets into %s (%u bytes)\n", pack.header->assetCount, argv[1], pack.header->fileSize);
+    assetPackClose(&pack);
+
+    for (int i = 0; i < count; i++) free(names[i]);
+    free(names);
+    free(sources);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../utility/dictionary.h"
+
+//compiles text word lists into one binary dictionary, the category name is the file name without .txt
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("usage: %s <output.dict> <words.txt>...\n", argv[0]);
+        return 1;
+    }
+
+    int count = argc - 2;
+    const char **paths = malloc(count * sizeof(char *));
+    char **names = malloc(count * sizeof(char *));
+    if (!paths || !names) return 1;
+
+    for (int i = 0; i < count; i++) {
+        const char *path = argv[i + 2];
+        const char *base = path;
+        for (const char *p = path; *p; p++) {
+            if (*p == '/' || *p == '\\') base = p + 1;
+        }
+
+        size_t len = strlen(base);
+        if (len > 4 && strcmp(base + len - 4, ".txt") == 0) len -= 4;
+
+        names[i] = malloc(len + 1);
+        memcpy(names[i], base, len);
+        names[i][len] = '\0';
+        paths[i] = path;
+    }
+
+    Dictionary dict;
+    if (!dictionaryBuildFromText(&dict, (const char *const *) names, paths, count)) {
+        printf("[ERROR] Failed to read word lists\n");
+        return 1;
+    }
+
+    if (!dictionaryWrite(&dict, argv[1])) {
+        printf("[ERROR] Failed to write %s\n", argv[1]);
+        dictionaryClose(&dict);
+        return 1;
+    }
+
+    printf("Packed %u words in %u categories into %s (%u bytes)\n",
+           dict.header->wordCount, dict.header->categoryCount, argv[1], dict.header->fileSize);
+
+    dictionaryClose(&dict);
+    for (int i = 0; i < count; i++) free(names[i]);
+    free(names);
+    free(paths);
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../bench/bench_common.h"
+#include "../game/hangman.h"
+#include "../game/solver.h"
+#include "../utility/difficulty_index.h"
+#include "../utility/utilities.h"
+#include "../utility/threads.h"
+
+//scores every dictionary word by letting the reference solver play it, then writes the difficulty sidecar
+//usage: difficulty_indexer <words.dict> <out.difficulty> [threads]
+//the score adds the wrong guesses of two reference players, played without a lives limit so words
+//that are lost anyway still rank against each other: the frequency player guesses like someone who
+//does not know the word list, the candidate solver like someone who knows it by heart
+
+typedef struct {
+    const Dictionary *dict;
+    float *scores;
+    uint32_t firstWord;
+    uint32_t wordCount;
+} IndexBatch;
+
+/**
+ * Plays one word to the end with the given strategy
+ *
+ * @return number of wrong guesses made
+ */
+static int countMisses(GuessStrategy strategy, const Dictionary *dict, uint32_t wordIndex) {
+    SolverContext context = {dict, dictionaryWordCategory(dict, wordIndex)};
+    GameState game = initHangman(dictionaryCategoryName(dict, context.category),
+                                 dictionaryWordString(dict, wordIndex), ALPHABET_SIZE, wordIndex);
+
+    //both players are deterministic, the generator only backs the fallback when no candidate is left
+    Prng rng;
+    prngSeed(&rng, wordIndex);
+
+    int guesses = 0;
+    while (!isGameWon(&game) && guesses < ALPHABET_SIZE) {
+        char guess = strategy(&game, &context, &rng);
+        if (!validateGuess(&game, guess)) break;
+
+        processGuess(&game, guess);
+        appendCharToArray(game.guessed, guess, &game.numGuessed, MAX_GUESSED);
+        guesses++;
+    }
+
+    return ALPHABET_SIZE - game.lives;
+}
+
+static float scoreWord(const Dictionary *dict, uint32_t wordIndex) {
+    return (float) (countMisses(strategyFrequencyGuess, dict, wordIndex) +
+                    countMisses(strategyCandidateGuess, dict, wordIndex));
+}
+
+static int indexThread(void *data) {
+    IndexBatch *batch = data;
+    for (uint32_t i = batch->firstWord; i < batch->firstWord + batch->wordCount; i++) {
+        batch->scores[i] = scoreWord(batch->dict, i);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        printf("usage: %s <words.dict> <out.difficulty> [threads]\n", argv[0]);
+        return 1;
+    }
+    int threadCount = argc > 3 ? atoi(argv[3]) : threadCpuCount();
+    if (threadCount < 1) threadCount = 1;
+
+    Dictionary dict;
+    if (!dictionaryOpen(&dict, argv[1])) {
+        printf("[ERROR] Failed to open dictionary: %s\n", argv[1]);
+        return 1;
+    }
+
+    uint32_t wordCount = dict.header->wordCount;
+    float *scores = calloc(wordCount ? wordCount : 1, sizeof(float));
+    IndexBatch *batches = calloc(threadCount, sizeof(IndexBatch));
+    Thread *threads = calloc(threadCount, sizeof(Thread));
+    if (!scores || !batches || !threads) {
+        printf("[ERROR] Out of memory\n");
+        return 1;
+    }
+
+    double start = nowSeconds();
+    for (int t = 0; t < threadCount; t++) {
+        batches[t].dict = &dict;
+        batches[t].scores = scores;
+        batches[t].firstWord = (uint32_t) ((uint64_t) wordCount * t / threadCount);
+        batches[t].wordCount = (uint32_t) ((uint64_t) wordCount * (t + 1) / threadCount) - batches[t].firstWord;
+        if (!threadCreate(&threads[t], indexThread, &batches[t])) {
+            printf("[ERROR] Failed to start thread\n");
+            return 1;
+        }
+    }
+    for (int t = 0; t < threadCount; t++) {
+        threadJoin(&threads[t]);
+    }
+    double elapsed = nowSeconds() - start;
+
+    if (!difficultyIndexWrite(argv[2], &dict, scores)) {
+        printf("[ERROR] Failed to write difficulty index: %s\n", argv[2]);
+        return 1;
+    }
+
+    DifficultyIndex index;
+    if (!difficultyIndexOpen(&index, argv[2], &dict)) {
+        printf("[ERROR] Written difficulty index does not load back: %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("Scored %u words on %d threads in %.2f s\n", wordCount, threadCount, elapsed);
+    printf("%-14s %8s %8s %8s %8s\n", "category", "words", "easy", "medium", "hard");
+    for (int c = 0; c < dictionaryCategoryCount(&dict); c++) {
+        const uint32_t *bands = index.bandStart + c * (DIFFICULTY_BAND_COUNT + 1);
+        printf("%-14s %8u", dictionaryCategoryName(&dict, c), dict.categories[c].wordCount);
+
+        //average score per band, a quick check that the bands are actually apart
+        for (int b = 0; b < DIFFICULTY_BAND_COUNT; b++) {
+            double sum = 0;
+            for (uint32_t i = bands[b]; i < bands[b + 1]; i++) sum += index.scores[index.order[i]];
+            printf(" %8.2f", bands[b + 1] > bands[b] ? sum / (bands[b + 1] - bands[b]) : 0.0);
+        }
+        printf("\n");
+    }
+
+    difficultyIndexClose(&index);
+    free(scores);
+    free(batches);
+    free(threads);
+    dictionaryClose(&dict);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "../bench/bench_common.h"
+#include "../game/hangman.h"
+#include "../game/solver.h"
+#include "../utility/utilities.h"
+#include "../utility/word_corpus.h"
+#include "../utility/threads.h"
+
+//plays games headless on every core and reports how each strategy does per category
+//usage: hangman_sim [games per category] [threads] [seed]
+//power ups are not simulated, a super blank hit is treated as a normal correct guess
+
+#define SIM_LIVES 6
+
+typedef struct {
+    long games;
+    long wins;
+    long guesses;
+} SimStats;
+
+typedef struct {
+    const Strategy *strategy;
+    SolverContext context;
+    uint64_t seed;
+    long firstGame;
+    long gameCount;
+    SimStats stats;
+} SimBatch;
+
+/**
+ * Plays one game to the end with the given strategy
+ *
+ * @return number of guesses made, negative if the game was lost
+ */
+static int playGame(const Strategy *strategy, const SolverContext *context, Prng *rng) {
+    int wordCount = (int) context->dict->categories[context->category].wordCount;
+    uint32_t wordIndex = context->dict->categories[context->category].firstWord + prngBounded(rng, wordCount);
+
+    GameState game = initHangman(dictionaryCategoryName(context->dict, context->category),
+                                 dictionaryWordString(context->dict, wordIndex), SIM_LIVES, prngNext(rng));
+
+    int guesses = 0;
+    while (!isGameOver(&game) && guesses < ALPHABET_SIZE) {
+        char guess = strategy->guess(&game, context, rng);
+        if (!validateGuess(&game, guess)) break;
+
+        processGuess(&game, guess);
+        appendCharToArray(game.guessed, guess, &game.numGuessed, MAX_GUESSED);
+        guesses++;
+    }
+
+    return isGameWon(&game) ? guesses : -guesses;
+}
+
+static int simThread(void *data) {
+    SimBatch *batch = data;
+
+    for (long i = batch->firstGame; i < batch->firstGame + batch->gameCount; i++) {
+        //seeding per game index keeps results identical for any thread count
+        Prng rng;
+        prngSeed(&rng, batch->seed + (uint64_t) i * 0x9E3779B97F4A7C15ULL);
+
+        int result = playGame(batch->strategy, &batch->context, &rng);
+        batch->stats.games++;
+        batch->stats.guesses += result < 0 ? -result : result;
+        if (result >= 0) batch->stats.wins++;
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    long gamesPerCategory = argc > 1 ? atol(argv[1]) : 100000;
+    int threadCount = argc > 2 ? atoi(argv[2]) : threadCpuCount();
+    uint64_t seed = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    if (threadCount < 1) threadCount = 1;
+
+    if (!wordCorpusInit()) {
+        printf("[ERROR] Failed to load words\n");
+        return 1;
+    }
+    const Dictionary *dict = wordCorpusDictionary();
+
+    SimBatch *batches = calloc(threadCount, sizeof(SimBatch));
+    Thread *threads = calloc(threadCount, sizeof(Thread));
+    if (!batches || !threads) return 1;
+
+    printf("%ld games per category, %d threads, seed %llu\n\n", gamesPerCategory, threadCount,
+           (unsigned long long) seed);
+    printf("%-12s %-14s %10s %9s %12s %14s\n", "strategy", "category", "games", "win rate", "avg guesses",
+           "games/sec");
+
+    for (int s = 0; s < g_strategyCount; s++) {
+        SimStats total = {0};
+        double totalTime = 0;
+
+        for (int c = 0; c < dictionaryCategoryCount(dict); c++) {
+            if (dict->categories[c].wordCount == 0) continue;
+
+            double start = nowSeconds();
+            for (int t = 0; t < threadCount; t++) {
+                SimBatch *batch = &batches[t];
+                batch->strategy = &g_strategies[s];
+                batch->context.dict = dict;
+                batch->context.category = c;
+                batch->seed = seed ^ ((uint64_t) s << 56) ^ ((uint64_t) c << 48);
+                batch->firstGame = gamesPerCategory * t / threadCount;
+                batch->gameCount = gamesPerCategory * (t + 1) / threadCount - batch->firstGame;
+                batch->stats = (SimStats) {0};
+                if (!threadCreate(&threads[t], simThread, batch)) {
+                    printf("[ERROR] Failed to start thread\n");
+                    return 1;
+                }
+            }
+
+            SimStats stats = {0};
+            for (int t = 0; t < threadCount; t++) {
+                threadJoin(&threads[t]);
+                stats.games += batches[t].stats.games;
+                stats.wins += batches[t].stats.wins;
+                stats.guesses += batches[t].stats.guesses;
+            }
+            double elapsed = nowSeconds() - start;
+
+            printf("%-12s %-14s %10ld %8.1f%% %12.2f %14.0f\n", g_strategies[s].name,
+                   dictionaryCategoryName(dict, c), stats.games, 100.0 * stats.wins / stats.games,
+                   (double) stats.guesses / stats.games, stats.games / elapsed);
+
+            total.games += stats.games;
+            total.wins += stats.wins;
+            total.guesses += stats.guesses;
+            totalTime += elapsed;
+        }
+
+        printf("%-12s %-14s %10ld %8.1f%% %12.2f %14.0f\n\n", g_strategies[s].name, "(all)", total.games,
+               100.0 * total.wins / total.games, (double) total.guesses / total.games, total.games / totalTime);
+    }
+
+    free(batches);
+    free(threads);
+    wordCorpusDestroy();
+    return 0;
+}
@@ -0,0 +1,354 @@
+#include <stdio.h>
+#include "anim_file.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t tileWidth(const AnimFileHeader *header, uint32_t tx) {
+    uint32_t x = tx * header->tileSize;
+    return header->width - x < header->tileSize ? header->width - x : header->tileSize;
+}
+
+static uint32_t tileHeight(const AnimFileHeader *header, uint32_t ty) {
+    uint32_t y = ty * header->tileSize;
+    return header->height - y < header->tileSize ? header->height - y : header->tileSize;
+}
+
+// ============================================================================
+// READING
+// ============================================================================
+
+//checks that the header and the frame table stay inside size bytes, tile records are checked as they are applied
+static bool animFileBind(AnimFile *anim, const void *data, size_t size) {
+    const AnimFileHeader *header = data;
+
+    bool valid = size >= sizeof(AnimFileHeader) &&
+                 memcmp(header->magic, ANIM_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == ANIM_FILE_VERSION &&
+                 header->fileSize == size &&
+                 header->width > 0 && header->height > 0 && header->frameCount > 0 &&
+                 header->tileSize > 0 && header->tileSize <= 256 &&
+                 header->tilesX == (header->width + header->tileSize - 1) / header->tileSize &&
+                 header->tilesY == (header->height + header->tileSize - 1) / header->tileSize &&
+                 (uint64_t) header->tilesX * header->tilesY <= UINT16_MAX + 1u &&
+                 header->frameTableOffset % 4 == 0 &&
+                 header->frameTableOffset + (uint64_t) (header->frameCount + 1) * sizeof(AnimFileFrame) <= size;
+
+    if (valid) {
+        const AnimFileFrame *frames = (const AnimFileFrame *) ((const char *) header + header->frameTableOffset);
+        for (uint32_t i = 0; i <= header->frameCount && valid; i++) {
+            valid = frames[i].offset % 4 == 0 && frames[i].offset + (uint64_t) frames[i].size <= size;
+        }
+    }
+    if (!valid) return false;
+
+    anim->header = header;
+    anim->frames = (const AnimFileFrame *) ((const char *) header + header->frameTableOffset);
+    return true;
+}
+
+/**
+ * Maps an animation file and checks that the header and the frame table stay inside it,
+ * tile records are checked as they are applied
+ *
+ * @param anim AnimFile struct to fill
+ * @param path path of the .hanim file written by anim_packer
+ * @return true if the file is a valid animation
+ */
+bool animFileOpen(AnimFile *anim, const char *path) {
+    memset(anim, 0, sizeof(*anim));
+    if (!mappedFileOpen(&anim->file, path)) return false;
+
+    if (!animFileBind(anim, anim->file.data, anim->file.size)) {
+        printf("[WARNING] Ignoring invalid animation file: %s\n", path);
+        animFileClose(anim);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Same as animFileOpen(), for an animation that is already in memory, such as one inside an asset pack
+ *
+ * @param anim AnimFile struct to fill
+ * @param data animation file contents, 4 byte aligned, has to outlive anim
+ * @param size bytes of data
+ * @return true if data is a valid animation
+ */
+bool animFileOpenMemory(AnimFile *anim, const void *data, size_t size) {
+    memset(anim, 0, sizeof(*anim));
+
+    if (!animFileBind(anim, data, size)) {
+        printf("[WARNING] Ignoring invalid packed animation\n");
+        return false;
+    }
+    return true;
+}
+
+void animFileClose(AnimFile *anim) {
+    mappedFileClose(&anim->file);
+    memset(anim, 0, sizeof(*anim));
+}
+
+/**
+ * @return number of tiles in one frame, the size a dirty tile array needs
+ */
+uint32_t animFileTileCount(const AnimFile *anim) {
+    return anim->header ? anim->header->tilesX * anim->header->tilesY : 0;
+}
+
+static bool decodeRle(const uint32_t *data, uint32_t words, uint32_t *canvas, uint32_t pitch, uint32_t w, uint32_t h) {
+    uint32_t x = 0, y = 0;
+    for (uint32_t i = 0; i + 1 < words; i += 2) {
+        uint32_t run = data[i], pixel = data[i + 1];
+        if (run > (h - y) * w - x) return false;
+
+        //runs continue across rows of the tile
+        while (run > 0) {
+            uint32_t span = w - x < run ? w - x : run;
+            uint32_t *dst = canvas + (size_t) y * pitch + x;
+            for (uint32_t k = 0; k < span; k++) dst[k] = pixel;
+            run -= span;
+            x += span;
+            if (x == w) {
+                x = 0;
+                y++;
+            }
+        }
+    }
+    return y == h && x == 0;
+}
+
+/**
+ * Writes the tiles one frame record changes into a full frame canvas. Records 1 to frameCount - 1 must be
+ * applied on top of the previous frame, record frameCount on top of the last frame, record 0 on anything
+ *
+ * @param anim an opened animation
+ * @param record frame table entry to apply
+ * @param canvas width * height pixels holding the frame the record starts from
+ * @param dirtyTiles receives 1 for every tile the record wrote, untouched entries are left as they were, may be NULL
+ * @return false if the record is out of range or corrupt, the canvas may then be partly written
+ */
+bool animFileApplyFrame(const AnimFile *anim, uint32_t record, uint32_t *canvas, uint8_t *dirtyTiles) {
+    const AnimFileHeader *header = anim->header;
+    if (!header || record > header->frameCount) return false;
+
+    const AnimFileFrame *frame = &anim->frames[record];
+    const char *data = (const char *) header + frame->offset;
+    const char *end = data + frame->size;
+    uint32_t tileCount = header->tilesX * header->tilesY;
+
+    for (uint32_t i = 0; i < frame->tileCount; i++) {
+        if ((size_t) (end - data) < sizeof(AnimFileTile)) return false;
+        const AnimFileTile *tile = (const AnimFileTile *) data;
+        data += sizeof(AnimFileTile);
+        if (tile->tile >= tileCount || tile->size % 4 != 0 || (size_t) (end - data) < tile->size) return false;
+
+        uint32_t tx = tile->tile % header->tilesX, ty = tile->tile / header->tilesX;
+        uint32_t w = tileWidth(header, tx), h = tileHeight(header, ty);
+        uint32_t *dst = canvas + (size_t) ty * header->tileSize * header->width + tx * header->tileSize;
+        const uint32_t *pixels = (const uint32_t *) data;
+
+        if (tile->encoding == ANIM_TILE_RAW) {
+            if (tile->size != w * h * sizeof(uint32_t)) return false;
+            for (uint32_t y = 0; y < h; y++) {
+                memcpy(dst + (size_t) y * header->width, pixels + y * w, w * sizeof(uint32_t));
+            }
+        } else if (tile->encoding == ANIM_TILE_RLE) {
+            if (!decodeRle(pixels, tile->size / 4, dst, header->width, w, h)) return false;
+        } else {
+            return false;
+        }
+
+        if (dirtyTiles) dirtyTiles[tile->tile] = 1;
+        data += tile->size;
+    }
+    return true;
+}
+
+// ============================================================================
+// WRITING
+// ============================================================================
+
+/**
+ * Starts an animation file, frames are then added in order with animWriterAddFrame()
+ *
+ * @param writer AnimWriter struct to initialise
+ * @param path output file
+ * @param width width of every frame in pixels
+ * @param height height of every frame in pixels
+ * @param frameCount number of frames that will be added
+ * @return true if the file was created
+ */
+bool animWriterBegin(AnimWriter *writer, const char *path, uint32_t width, uint32_t height, uint32_t frameCount) {
+    memset(writer, 0, sizeof(*writer));
+    uint32_t tileSize = ANIM_FILE_TILE_SIZE;
+    uint32_t tilesX = (width + tileSize - 1) / tileSize;
+    uint32_t tilesY = (height + tileSize - 1) / tileSize;
+    if (width == 0 || height == 0 || frameCount == 0 || (uint64_t) tilesX * tilesY > UINT16_MAX + 1u) return false;
+
+    size_t pixels = (size_t) width * height;
+    writer->frames = calloc(frameCount + 1, sizeof(AnimFileFrame));
+    writer->first = malloc(pixels * sizeof(uint32_t));
+    writer->previous = malloc(pixels * sizeof(uint32_t));
+    //an RLE tile is kept only when it is smaller than the raw tile, so one raw tile bounds the scratch
+    writer->scratch = malloc((size_t) tileSize * tileSize * sizeof(uint32_t));
+    if (!writer->frames || !writer->first || !writer->previous || !writer->scratch) {
+        animWriterAbort(writer);
+        return false;
+    }
+
+    snprintf(writer->path, sizeof(writer->path), "%s", path);
+    writer->file = mappedFileCreate(path, writer->tempPath, sizeof(writer->tempPath));
+    if (!writer->file) {
+        animWriterAbort(writer);
+        return false;
+    }
+
+    AnimFileHeader *header = &writer->header;
+    memcpy(header->magic, ANIM_FILE_MAGIC, sizeof(header->magic));
+    header->version = ANIM_FILE_VERSION;
+    header->width = width;
+    header->height = height;
+    header->tileSize = tileSize;
+    header->tilesX = tilesX;
+    header->tilesY = tilesY;
+    header->frameCount = frameCount;
+
+    //the header is rewritten once the frame table offset is known
+    if (fwrite(header, sizeof(*header), 1, writer->file) != 1) {
+        animWriterAbort(writer);
+        return false;
+    }
+    return true;
+}
+
+static bool tileChanged(const AnimFileHeader *header, const uint32_t *a, const uint32_t *b, uint32_t w, uint32_t h) {
+    for (uint32_t y = 0; y < h; y++) {
+        if (memcmp(a + (size_t) y * header->width, b + (size_t) y * header->width, w * sizeof(uint32_t)) != 0) return true;
+    }
+    return false;
+}
+
+/**
+ * Run length encodes a tile into out
+ *
+ * @return bytes written, or 0 if the encoding would not be smaller than limit bytes
+ */
+static uint32_t encodeRle(const AnimFileHeader *header, const uint32_t *src, uint32_t w, uint32_t h, uint32_t *out,
+                          uint32_t limit) {
+    uint32_t words = 0, run = 0, pixel = 0;
+    for (uint32_t y = 0; y < h; y++) {
+        const uint32_t *row = src + (size_t) y * header->width;
+        for (uint32_t x = 0; x < w; x++) {
+            if (run > 0 && row[x] == pixel) {
+                run++;
+                continue;
+            }
+            if (run > 0) {
+                if ((words + 2) * 4 >= limit) return 0;
+                out[words++] = run;
+                out[words++] = pixel;
+            }
+            pixel = row[x];
+            run = 1;
+        }
+    }
+    if ((words + 2) * 4 >= limit) return 0;
+    out[words++] = run;
+    out[words++] = pixel;
+    return words * 4;
+}
+
+/**
+ * Writes every tile of pixels that differs from base, or every tile when base is NULL
+ */
+static bool writeFrameRecord(AnimWriter *writer, uint32_t record, const uint32_t *pixels, const uint32_t *base) {
+    const AnimFileHeader *header = &writer->header;
+    AnimFileFrame *frame = &writer->frames[record];
+    frame->offset = (uint32_t) ftell(writer->file);
+
+    for (uint32_t ty = 0; ty < header->tilesY; ty++) {
+        for (uint32_t tx = 0; tx < header->tilesX; tx++) {
+            uint32_t w = tileWidth(header, tx), h = tileHeight(header, ty);
+            size_t origin = (size_t) ty * header->tileSize * header->width + tx * header->tileSize;
+            if (base && !tileChanged(header, pixels + origin, base + origin, w, h)) continue;
+
+            AnimFileTile tile = {(uint16_t) (ty * header->tilesX + tx), ANIM_TILE_RLE, 0, 0};
+            uint32_t rawSize = w * h * (uint32_t) sizeof(uint32_t);
+            tile.size = encodeRle(header, pixels + origin, w, h, writer->scratch, rawSize);
+            if (tile.size == 0) {
+                tile.encoding = ANIM_TILE_RAW;
+                tile.size = rawSize;
+                for (uint32_t y = 0; y < h; y++) {
+                    memcpy(writer->scratch + y * w, pixels + origin + (size_t) y * header->width, w * sizeof(uint32_t));
+                }
+            }
+
+            if (fwrite(&tile, sizeof(tile), 1, writer->file) != 1 ||
+                fwrite(writer->scratch, 1, tile.size, writer->file) != tile.size) {
+                return false;
+            }
+            frame->tileCount++;
+            frame->size += (uint32_t) sizeof(tile) + tile.size;
+        }
+    }
+    writer->tilesWritten += frame->tileCount;
+    return true;
+}
+
+/**
+ * Adds the next frame, only the tiles that changed since the previous frame are written
+ *
+ * @param writer a started writer
+ * @param pixels width * height ARGB pixels
+ * @return false if the frame could not be written or all frames were already added
+ */
+bool animWriterAddFrame(AnimWriter *writer, const uint32_t *pixels) {
+    if (!writer->file || writer->framesWritten >= writer->header.frameCount) return false;
+
+    const uint32_t *base = writer->framesWritten == 0 ? NULL : writer->previous;
+    if (!writeFrameRecord(writer, writer->framesWritten, pixels, base)) return false;
+
+    size_t bytes = (size_t) writer->header.width * writer->header.height * sizeof(uint32_t);
+    if (writer->framesWritten == 0) memcpy(writer->first, pixels, bytes);
+    memcpy(writer->previous, pixels, bytes);
+    writer->framesWritten++;
+    return true;
+}
+
+/**
+ * Writes the loop delta, the frame table and the final header, then closes the file
+ *
+ * @return true if every frame was added and the file is complete
+ */
+bool animWriterFinish(AnimWriter *writer) {
+    bool ok = writer->file && writer->framesWritten == writer->header.frameCount &&
+              writeFrameRecord(writer, writer->header.frameCount, writer->first, writer->previous);
+
+    if (ok) {
+        writer->header.frameTableOffset = (uint32_t) ftell(writer->file);
+        ok = fwrite(writer->frames, sizeof(AnimFileFrame), writer->header.frameCount + 1, writer->file) ==
+             writer->header.frameCount + 1;
+        writer->header.fileSize = (uint32_t) ftell(writer->file);
+        ok = ok && fseek(writer->file, 0, SEEK_SET) == 0 &&
+             fwrite(&writer->header, sizeof(writer->header), 1, writer->file) == 1;
+    }
+
+    if (writer->file) ok = mappedFileCommit(writer->file, writer->tempPath, writer->path, ok);
+    writer->file = NULL;
+    animWriterAbort(writer);
+    return ok;
+}
+
+/**
+ * Frees the writer, a file that was not finished is deleted and the old file at path is kept
+ */
+void animWriterAbort(AnimWriter *writer) {
+    if (writer->file) mappedFileCommit(writer->file, writer->tempPath, writer->path, false);
+    free(writer->frames);
+    free(writer->first);
+    free(writer->previous);
+    free(writer->scratch);
+    memset(writer, 0, sizeof(*writer));
+}
@@ -0,0 +1,95 @@
+#ifndef HANGMAN_ANIM_FILE_H
+#define HANGMAN_ANIM_FILE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "mapped_file.h"
+
+// ============================================================================
+// ANIMATION FORMAT (little endian, every offset is from the start of the file)
+//
+//   AnimFileHeader
+//   tile records of every frame, each an AnimFileTile followed by its data
+//   AnimFileFrame[frameCount + 1]   frame 0 holds every tile, frame i only the tiles that differ from frame i - 1,
+//                                   the extra last entry turns the last frame back into frame 0 for looping
+//
+// pixels are 32 bit ARGB, tiles are tileSize squared and clipped at the right and bottom edges
+// ============================================================================
+
+#define ANIM_FILE_MAGIC "HNGANIM"
+#define ANIM_FILE_VERSION 1
+#define ANIM_FILE_TILE_SIZE 32
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t tileSize;
+    uint32_t tilesX;
+    uint32_t tilesY;
+    uint32_t frameCount;
+    uint32_t frameTableOffset;
+    uint32_t fileSize;
+} AnimFileHeader;
+
+typedef struct {
+    uint32_t offset;
+    uint32_t size;      //bytes of tile records
+    uint32_t tileCount; //tiles this frame changes
+    uint32_t reserved;
+} AnimFileFrame;
+
+typedef enum {
+    ANIM_TILE_RAW = 0, //every pixel of the tile, row by row
+    ANIM_TILE_RLE = 1  //uint32_t pairs of run length and pixel, row by row
+} AnimTileEncoding;
+
+typedef struct {
+    uint16_t tile; //ty * tilesX + tx
+    uint8_t encoding;
+    uint8_t reserved;
+    uint32_t size; //bytes of data after this record
+} AnimFileTile;
+
+typedef struct {
+    const AnimFileHeader *header;
+    const AnimFileFrame *frames;
+    MappedFile file; //empty when opened from memory
+} AnimFile;
+
+//streams frames into an animation file, only the header and the frame table are kept in memory besides two frames
+typedef struct {
+    FILE *file;         //written under tempPath, renamed to path by animWriterFinish()
+    char path[512];
+    char tempPath[560];
+    AnimFileHeader header;
+    AnimFileFrame *frames;
+    uint32_t framesWritten;
+    uint32_t *first;    //frame 0, needed for the loop delta
+    uint32_t *previous; //last frame added
+    uint32_t *scratch;  //encoded tile data
+    uint64_t tilesWritten;
+} AnimWriter;
+
+bool animFileOpen(AnimFile *anim, const char *path);
+
+bool animFileOpenMemory(AnimFile *anim, const void *data, size_t size);
+
+void animFileClose(AnimFile *anim);
+
+uint32_t animFileTileCount(const AnimFile *anim);
+
+bool animFileApplyFrame(const AnimFile *anim, uint32_t record, uint32_t *canvas, uint8_t *dirtyTiles);
+
+bool animWriterBegin(AnimWriter *writer, const char *path, uint32_t width, uint32_t height, uint32_t frameCount);
+
+bool animWriterAddFrame(AnimWriter *writer, const uint32_t *pixels);
+
+bool animWriterFinish(AnimWriter *writer);
+
+void animWriterAbort(AnimWriter *writer);
+
+#endif
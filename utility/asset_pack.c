@@ -0,0 +1,320 @@
+#include "asset_pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//the pack the game reads its resources from, empty when the resources are loose files
+static AssetPack g_mountedPack;
+
+static const char g_padding[ASSET_PACK_ALIGNMENT] = {0};
+
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t length) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint32_t alignUp(uint32_t value) {
+    return (value + ASSET_PACK_ALIGNMENT - 1) & ~(uint32_t) (ASSET_PACK_ALIGNMENT - 1);
+}
+
+/**
+ * 64 bit FNV-1a of an asset name, or of any other bytes that need a content hash
+ *
+ * @param name asset name, does not have to be null terminated
+ * @param length bytes of name to hash
+ * @return hash the directory is probed with
+ */
+uint64_t assetPackHash(const char *name, size_t length) {
+    return hashBytes(0xcbf29ce484222325ull, name, length);
+}
+
+// ============================================================================
+// READING
+// ============================================================================
+
+/**
+ * Maps an asset pack and checks that the directory and every asset stay inside it,
+ * asset data is not touched until it is used
+ *
+ * @param pack AssetPack struct to fill
+ * @param path path of the pack written by asset_packer
+ * @return true if the file is a valid pack
+ */
+bool assetPackOpen(AssetPack *pack, const char *path) {
+    memset(pack, 0, sizeof(*pack));
+    if (!mappedFileOpen(&pack->file, path)) return false;
+
+    const AssetPackHeader *header = pack->file.data;
+    size_t size = pack->file.size;
+
+    bool valid = size >= sizeof(AssetPackHeader) &&
+                 memcmp(header->magic, ASSET_PACK_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == ASSET_PACK_VERSION &&
+                 header->fileSize == size &&
+                 header->slotCount > 0 && (header->slotCount & (header->slotCount - 1)) == 0 &&
+                 header->assetCount < header->slotCount &&
+                 header->slotTableOffset % 8 == 0 &&
+                 header->slotTableOffset + (uint64_t) header->slotCount * sizeof(AssetPackSlot) <= size &&
+                 header->namesOffset + (uint64_t) header->namesSize <= size;
+
+    if (valid) {
+        const AssetPackSlot *slots = (const AssetPackSlot *) ((const char *) header + header->slotTableOffset);
+        uint32_t used = 0;
+        for (uint32_t i = 0; i < header->slotCount && valid; i++) {
+            if (slots[i].nameLength == 0) continue;
+            used++;
+            valid = slots[i].nameOffset + (uint64_t) slots[i].nameLength <= header->namesSize &&
+                    slots[i].dataOffset + (uint64_t) slots[i].dataSize <= size;
+        }
+        valid = valid && used == header->assetCount;
+    }
+
+    if (!valid) {
+        printf("[WARNING] Ignoring invalid asset pack: %s\n", path);
+        assetPackClose(pack);
+        return false;
+    }
+
+    pack->header = header;
+    pack->slots = (const AssetPackSlot *) ((const char *) header + header->slotTableOffset);
+    pack->names = (const char *) header + header->namesOffset;
+    return true;
+}
+
+void assetPackClose(AssetPack *pack) {
+    mappedFileClose(&pack->file);
+    memset(pack, 0, sizeof(*pack));
+}
+
+static const AssetPackSlot *findSlot(const AssetPack *pack, const char *name) {
+    if (!pack->header || !name) return NULL;
+
+    size_t length = strlen(name);
+    uint64_t hash = assetPackHash(name, length);
+    uint32_t mask = pack->header->slotCount - 1;
+
+    //the table is never full, so the probe always ends on an unused slot
+    for (uint32_t i = (uint32_t) hash & mask;; i = (i + 1) & mask) {
+        const AssetPackSlot *slot = &pack->slots[i];
+        if (slot->nameLength == 0) return NULL;
+        if (slot->hash != hash || slot->nameLength != length) continue;
+        if (memcmp(pack->names + slot->nameOffset, name, length) == 0) return slot;
+    }
+}
+
+/**
+ * Looks an asset up by name, one hash and usually a single probe
+ *
+ * @param pack an open pack, a zeroed struct finds nothing
+ * @param name asset name, the path it was packed under
+ * @param size receives the asset size in bytes, may be NULL
+ * @return the asset bytes inside the mapping, or NULL if the pack does not hold it
+ */
+const void *assetPackFind(const AssetPack *pack, const char *name, size_t *size) {
+    const AssetPackSlot *slot = findSlot(pack, name);
+    if (!slot) return NULL;
+
+    if (size) *size = slot->dataSize;
+    return (const char *) pack->header + slot->dataOffset;
+}
+
+// ============================================================================
+// WRITING
+// ============================================================================
+
+//copies a whole file to out and hashes it, size is checked against what was measured when the layout was planned
+static bool copyFile(FILE *out, const char *path, uint32_t size, uint64_t *hash) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    char buffer[64 * 1024];
+    uint32_t copied = 0;
+    size_t read;
+    bool ok = true;
+    *hash = 0xcbf29ce484222325ull;
+    while (ok && (read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        copied += (uint32_t) read;
+        *hash = hashBytes(*hash, buffer, read);
+        ok = copied <= size && fwrite(buffer, 1, read, out) == read;
+    }
+    fclose(file);
+    return ok && copied == size;
+}
+
+static long measureFile(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+    long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    fclose(file);
+    return size;
+}
+
+/**
+ * Writes every source file into one pack that can be mapped with assetPackOpen() later
+ * The files are streamed one at a time, only the directory is kept in memory
+ *
+ * @param path output file
+ * @param sources name and file of each asset, names have to be unique
+ * @param count number of assets
+ * @return true if every file was read and the whole pack was written
+ */
+bool assetPackWrite(const char *path, const AssetPackSource *sources, int count) {
+    uint32_t slotCount = 2;
+    while (slotCount < (uint32_t) count * 2) slotCount *= 2;
+
+    AssetPackSlot *slots = calloc(slotCount, sizeof(AssetPackSlot));
+    uint32_t *sizes = calloc(count > 0 ? count : 1, sizeof(uint32_t));
+    if (!slots || !sizes) {
+        free(slots);
+        free(sizes);
+        return false;
+    }
+
+    //plan the layout first so the data can be streamed straight to its place
+    uint64_t namesSize = 0;
+    uint64_t dataSize = 0;
+    bool ok = true;
+    for (int i = 0; i < count && ok; i++) {
+        long size = measureFile(sources[i].path);
+        ok = size >= 0;
+        sizes[i] = (uint32_t) size;
+        namesSize += strlen(sources[i].name);
+        dataSize += alignUp(sizes[i]);
+    }
+
+    uint32_t slotTableOffset = alignUp(sizeof(AssetPackHeader));
+    uint32_t namesOffset = slotTableOffset + slotCount * (uint32_t) sizeof(AssetPackSlot);
+    uint64_t dataOffset = alignUp(namesOffset + (uint32_t) namesSize);
+    if (ok && dataOffset + dataSize > UINT32_MAX) {
+        printf("[ERROR] Asset pack would be larger than 4 GiB\n");
+        ok = false;
+    }
+
+    char tempPath[1024];
+    char *names = ok ? malloc(namesSize > 0 ? namesSize : 1) : NULL;
+    FILE *file = ok && names ? mappedFileCreate(path, tempPath, sizeof(tempPath)) : NULL;
+    ok = ok && file;
+
+    uint32_t nameOffset = 0;
+    uint32_t offset = (uint32_t) dataOffset;
+    if (ok) ok = fseek(file, (long) offset, SEEK_SET) == 0;
+    for (int i = 0; i < count && ok; i++) {
+        size_t length = strlen(sources[i].name);
+        if (length == 0) {
+            printf("[ERROR] Asset %s has an empty name\n", sources[i].path);
+            ok = false;
+            break;
+        }
+
+        uint64_t hash = assetPackHash(sources[i].name, length);
+        uint32_t mask = slotCount - 1;
+        uint32_t s = (uint32_t) hash & mask;
+        for (; slots[s].nameLength != 0; s = (s + 1) & mask) {
+            if (slots[s].hash == hash && slots[s].nameLength == length &&
+                memcmp(names + slots[s].nameOffset, sources[i].name, length) == 0) {
+                printf("[ERROR] Asset %s is packed twice\n", sources[i].name);
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) break;
+
+        memcpy(names + nameOffset, sources[i].name, length);
+        slots[s] = (AssetPackSlot) {hash, 0, nameOffset, (uint32_t) length, offset, sizes[i]};
+        nameOffset += (uint32_t) length;
+
+        ok = copyFile(file, sources[i].path, sizes[i], &slots[s].dataHash);
+        if (!ok) {
+            printf("[ERROR] Failed to copy %s into the pack\n", sources[i].path);
+            break;
+        }
+
+        //pad so the next asset starts aligned
+        uint32_t padded = alignUp(sizes[i]);
+        ok = fwrite(g_padding, 1, padded - sizes[i], file) == padded - sizes[i];
+        offset += padded;
+    }
+
+    if (ok) {
+        AssetPackHeader header = {0};
+        memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+        header.version = ASSET_PACK_VERSION;
+        header.assetCount = (uint32_t) count;
+        header.slotCount = slotCount;
+        header.slotTableOffset = slotTableOffset;
+        header.namesOffset = namesOffset;
+        header.namesSize = (uint32_t) namesSize;
+        header.fileSize = offset;
+
+        ok = fseek(file, 0, SEEK_SET) == 0 &&
+             fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(g_padding, 1, slotTableOffset - sizeof(header), file) == slotTableOffset - sizeof(header) &&
+             fwrite(slots, sizeof(AssetPackSlot), slotCount, file) == slotCount &&
+             (namesSize == 0 || fwrite(names, 1, namesSize, file) == namesSize);
+    }
+
+    if (file) ok = mappedFileCommit(file, tempPath, path, ok);
+    free(names);
+    free(sizes);
+    free(slots);
+    return ok;
+}
+
+// ============================================================================
+// MOUNTED PACK
+// ============================================================================
+
+/**
+ * Maps the pack the game loads its resources from, call before anything is loaded
+ *
+ * @param path path of the pack
+ * @return true if the pack was mapped, when it is not every resource is read from its own file
+ */
+bool assetPackMount(const char *path) {
+    assetPackUnmount();
+    return assetPackOpen(&g_mountedPack, path);
+}
+
+/**
+ * Unmaps the mounted pack, every asset handed out by assetPackGet() becomes invalid
+ */
+void assetPackUnmount(void) {
+    assetPackClose(&g_mountedPack);
+}
+
+/**
+ * Looks an asset up in the mounted pack, safe to call from any thread once the pack is mounted
+ *
+ * @param name asset name, the path the resource has on disk
+ * @param size receives the asset size in bytes, may be NULL
+ * @return the asset bytes, or NULL when no pack is mounted or it does not hold name
+ */
+const void *assetPackGet(const char *name, size_t *size) {
+    return assetPackFind(&g_mountedPack, name, size);
+}
+
+/**
+ * Hash of a packed asset's bytes, computed when the pack was built so it costs nothing to ask for
+ *
+ * @param name asset name, the path the resource has on disk
+ * @param hash receives the hash
+ * @return false when no pack is mounted or it does not hold name
+ */
+bool assetPackGetHash(const char *name, uint64_t *hash) {
+    const AssetPackSlot *slot = findSlot(&g_mountedPack, name);
+    if (!slot) return false;
+
+    *hash = slot->dataHash;
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef HANGMAN_ASSET_PACK_H
+#define HANGMAN_ASSET_PACK_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mapped_file.h"
+
+// ============================================================================
+// PACK FORMAT (little endian, every offset is from the start of the file)
+//
+//   AssetPackHeader
+//   AssetPackSlot[slotCount]   open addressed by FNV-1a of the asset name, linear probing, an unused slot has no name
+//   char names[namesSize]      asset names, not null terminated
+//   asset data                 each asset starts on an ASSET_PACK_ALIGNMENT boundary so packed tables can be read in place
+// ============================================================================
+
+#define ASSET_PACK_MAGIC "HNGPACK"
+#define ASSET_PACK_VERSION 2
+#define ASSET_PACK_ALIGNMENT 16
+#define ASSET_PACK_DEFAULT_PATH "resources/assets.pak"
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t assetCount;
+    uint32_t slotCount; //power of two, at least twice assetCount
+    uint32_t slotTableOffset;
+    uint32_t namesOffset;
+    uint32_t namesSize;
+    uint32_t fileSize;
+    uint32_t reserved;
+} AssetPackHeader;
+
+typedef struct {
+    uint64_t hash;
+    uint64_t dataHash;   //FNV-1a of the asset bytes, lets caches derived from an asset notice it changed
+    uint32_t nameOffset; //inside names
+    uint32_t nameLength; //0 for an unused slot
+    uint32_t dataOffset;
+    uint32_t dataSize;
+} AssetPackSlot;
+
+typedef struct {
+    const AssetPackHeader *header;
+    const AssetPackSlot *slots;
+    const char *names;
+    MappedFile file;
+} AssetPack;
+
+typedef struct {
+    const char *name; //name the game looks the asset up by, the path relative to the working directory
+    const char *path; //file to read it from
+} AssetPackSource;
+
+uint64_t assetPackHash(const char *name, size_t length);
+
+bool assetPackOpen(AssetPack *pack, const char *path);
+
+void assetPackClose(AssetPack *pack);
+
+const void *assetPackFind(const AssetPack *pack, const char *name, size_t *size);
+
+bool assetPackWrite(const char *path, const AssetPackSource *sources, int count);
+
+bool assetPackMount(const char *path);
+
+void assetPackUnmount(void);
+
+const void *assetPackGet(const char *name, size_t *size);
+
+bool assetPackGetHash(const char *name, uint64_t *hash);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef HANGMAN_BITS_H
+#define HANGMAN_BITS_H
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//number of set bits
+static inline int bitCount64(uint64_t x) {
+#ifdef _MSC_VER
+    return (int) __popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+static inline int bitCount32(uint32_t x) {
+    return bitCount64(x);
+}
+
+//index of the lowest set bit, x must not be 0
+static inline int lowestBitIndex64(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int) index;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+//index of the n-th (0 based) set bit counted from the lowest, x must have more than n bits set
+static inline int nthBitIndex64(uint64_t x, int n) {
+    while (n-- > 0) x &= x - 1;
+    return lowestBitIndex64(x);
+}
+
+#endif
@@ -0,0 +1,427 @@
+#include <stdio.h>
+#include "dictionary.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+
+//words longer than this cannot fit inside a GameState and are skipped when packing
+#define DICTIONARY_MAX_WORD_LENGTH 127
+
+typedef struct {
+    uint32_t category;
+    uint32_t textOffset;
+    uint32_t length;
+} PendingWord;
+
+//scratch state used while turning text files into a dictionary image
+typedef struct {
+    char *text;
+    size_t textSize;
+    size_t textCapacity;
+
+    PendingWord *words;
+    uint32_t wordCount;
+    uint32_t wordCapacity;
+} DictionaryBuilder;
+
+static const char *builderText;
+
+/**
+ * Computes the letter metadata stored for every word
+ *
+ * @param word lowercase word
+ * @param distinctLetters receives the number of different letters, may be NULL
+ * @param letterCount receives the number of a-z characters, may be NULL
+ * @return bitmask where bit i is set when 'a' + i appears in the word
+ */
+uint32_t dictionaryLetterMask(const char *word, int *distinctLetters, int *letterCount) {
+    uint32_t mask = 0;
+    int letters = 0;
+
+    for (int i = 0; word[i] != '\0'; i++) {
+        if (word[i] >= 'a' && word[i] <= 'z') {
+            mask |= 1u << (word[i] - 'a');
+            letters++;
+        }
+    }
+
+    if (distinctLetters) {
+        int distinct = 0;
+        for (uint32_t m = mask; m; m &= m - 1) distinct++;
+        *distinctLetters = distinct;
+    }
+    if (letterCount) *letterCount = letters;
+
+    return mask;
+}
+
+static bool builderAppendText(DictionaryBuilder *builder, const char *text, size_t length, uint32_t *offset) {
+    if (builder->textSize + length + 1 > builder->textCapacity) {
+        size_t newCapacity = builder->textCapacity ? builder->textCapacity * 2 : 65536;
+        while (newCapacity < builder->textSize + length + 1) newCapacity *= 2;
+
+        char *newText = realloc(builder->text, newCapacity);
+        if (!newText) return false;
+        builder->text = newText;
+        builder->textCapacity = newCapacity;
+    }
+
+    *offset = (uint32_t) builder->textSize;
+    for (size_t i = 0; i < length; i++) {
+        builder->text[builder->textSize + i] = (char) tolower((unsigned char) text[i]);
+    }
+    builder->text[builder->textSize + length] = '\0';
+    builder->textSize += length + 1;
+    return true;
+}
+
+static bool builderAppendWord(DictionaryBuilder *builder, uint32_t category, const char *word, size_t length) {
+    if (builder->wordCount >= builder->wordCapacity) {
+        uint32_t newCapacity = builder->wordCapacity ? builder->wordCapacity * 2 : 1024;
+
+        PendingWord *newWords = realloc(builder->words, newCapacity * sizeof(PendingWord));
+        if (!newWords) return false;
+        builder->words = newWords;
+        builder->wordCapacity = newCapacity;
+    }
+
+    PendingWord *pending = &builder->words[builder->wordCount];
+    if (!builderAppendText(builder, word, length, &pending->textOffset)) return false;
+    pending->category = category;
+    pending->length = (uint32_t) length;
+    builder->wordCount++;
+    return true;
+}
+
+/**
+ * Reads a word list and queues every non empty line under the given category
+ */
+static bool builderLoadFile(DictionaryBuilder *builder, uint32_t category, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror("Failed to open file");
+        return false;
+    }
+
+    char block[65536];
+    char line[DICTIONARY_MAX_WORD_LENGTH + 1];
+    size_t lineLen = 0;
+    bool lineTooLong = false;
+    bool ok = true;
+    size_t read;
+
+    //lines are assembled across block boundaries, overlong lines are dropped whole
+    while (ok && (read = fread(block, 1, sizeof(block), file)) > 0) {
+        for (size_t i = 0; i < read && ok; i++) {
+            char c = block[i];
+            if (c == '\n') {
+                while (lineLen > 0 && line[lineLen - 1] == '\r') lineLen--;
+                if (lineLen > 0 && !lineTooLong) ok = builderAppendWord(builder, category, line, lineLen);
+                lineLen = 0;
+                lineTooLong = false;
+            } else if (lineLen < DICTIONARY_MAX_WORD_LENGTH) {
+                line[lineLen++] = c;
+            } else {
+                lineTooLong = true;
+            }
+        }
+    }
+    while (lineLen > 0 && line[lineLen - 1] == '\r') lineLen--;
+    if (ok && lineLen > 0 && !lineTooLong) ok = builderAppendWord(builder, category, line, lineLen);
+
+    fclose(file);
+    return ok;
+}
+
+static int comparePendingWords(const void *a, const void *b) {
+    const PendingWord *wa = a;
+    const PendingWord *wb = b;
+    if (wa->category != wb->category) return wa->category < wb->category ? -1 : 1;
+    if (wa->length != wb->length) return wa->length < wb->length ? -1 : 1;
+    return strcmp(builderText + wa->textOffset, builderText + wb->textOffset);
+}
+
+static bool dictionaryBind(Dictionary *dict, const void *data, size_t size) {
+    if (size < sizeof(DictionaryHeader)) return false;
+
+    const DictionaryHeader *header = data;
+    if (memcmp(header->magic, DICTIONARY_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->version != DICTIONARY_VERSION || header->fileSize != size) return false;
+
+    //only the tables are validated here so opening stays independent of corpus size
+    uint64_t categoryEnd = header->categoryTableOffset + (uint64_t) header->categoryCount * sizeof(DictionaryCategory);
+    uint64_t wordEnd = header->wordTableOffset + (uint64_t) header->wordCount * sizeof(DictionaryWord);
+    uint64_t stringsEnd = header->stringsOffset + (uint64_t) header->stringsSize;
+    if (categoryEnd > size || wordEnd > size || stringsEnd > size || header->stringsSize == 0) return false;
+
+    const DictionaryCategory *categories = (const DictionaryCategory *) ((const char *) data + header->categoryTableOffset);
+    for (uint32_t i = 0; i < header->categoryCount; i++) {
+        if ((uint64_t) categories[i].firstWord + categories[i].wordCount > header->wordCount) return false;
+        if (categories[i].nameOffset >= header->stringsSize) return false;
+    }
+
+    dict->header = header;
+    dict->categories = categories;
+    dict->words = (const DictionaryWord *) ((const char *) data + header->wordTableOffset);
+    dict->strings = (const char *) data + header->stringsOffset;
+    return true;
+}
+
+/**
+ * Opens a packed dictionary by mapping it read only, word data is only paged in when it is used
+ *
+ * @param dict Dictionary struct to fill
+ * @param path path of the .dict file written by dict_packer
+ * @return true if the file exists and has a valid header and tables
+ */
+bool dictionaryOpen(Dictionary *dict, const char *path) {
+    memset(dict, 0, sizeof(*dict));
+
+    if (!mappedFileOpen(&dict->file, path)) return false;
+
+    if (!dictionaryBind(dict, dict->file.data, dict->file.size)) {
+        printf("[ERROR] Invalid dictionary file: %s\n", path);
+        dictionaryClose(dict);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Same as dictionaryOpen(), for a packed dictionary that is already in memory, such as one inside an asset pack
+ *
+ * @param dict Dictionary struct to fill
+ * @param data .dict file contents, 4 byte aligned, has to outlive dict
+ * @param size bytes of data
+ * @return true if data has a valid header and tables
+ */
+bool dictionaryOpenMemory(Dictionary *dict, const void *data, size_t size) {
+    memset(dict, 0, sizeof(*dict));
+
+    if (!dictionaryBind(dict, data, size)) {
+        printf("[ERROR] Invalid packed dictionary\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Builds a dictionary image in memory from text word lists, one word per line
+ * The image has exactly the same layout as a packed .dict file
+ *
+ * @param dict Dictionary struct to fill
+ * @param names category names, one per file
+ * @param paths paths of the text files
+ * @param count number of categories
+ * @return true if every file was read
+ */
+bool dictionaryBuildFromText(Dictionary *dict, const char *const *names, const char *const *paths, int count) {
+    memset(dict, 0, sizeof(*dict));
+
+    DictionaryBuilder builder = {0};
+    bool ok = true;
+    for (int i = 0; i < count && ok; i++) {
+        ok = builderLoadFile(&builder, (uint32_t) i, paths[i]);
+    }
+    if (!ok) {
+        free(builder.text);
+        free(builder.words);
+        return false;
+    }
+
+    builderText = builder.text;
+    if (builder.wordCount > 0) qsort(builder.words, builder.wordCount, sizeof(PendingWord), comparePendingWords);
+    builderText = NULL;
+
+    size_t namesSize = 0;
+    for (int i = 0; i < count; i++) namesSize += strlen(names[i]) + 1;
+
+    uint32_t categoryTableOffset = sizeof(DictionaryHeader);
+    uint32_t wordTableOffset = categoryTableOffset + (uint32_t) (count * sizeof(DictionaryCategory));
+    uint32_t stringsOffset = wordTableOffset + builder.wordCount * (uint32_t) sizeof(DictionaryWord);
+    uint32_t stringsSize = (uint32_t) (namesSize + builder.textSize);
+    uint32_t fileSize = stringsOffset + stringsSize;
+
+    char *image = calloc(1, fileSize);
+    if (!image) {
+        free(builder.text);
+        free(builder.words);
+        return false;
+    }
+
+    DictionaryHeader *header = (DictionaryHeader *) image;
+    memcpy(header->magic, DICTIONARY_MAGIC, sizeof(header->magic));
+    header->version = DICTIONARY_VERSION;
+    header->categoryCount = (uint32_t) count;
+    header->wordCount = builder.wordCount;
+    header->categoryTableOffset = categoryTableOffset;
+    header->wordTableOffset = wordTableOffset;
+    header->stringsOffset = stringsOffset;
+    header->stringsSize = stringsSize;
+    header->fileSize = fileSize;
+
+    DictionaryCategory *categories = (DictionaryCategory *) (image + categoryTableOffset);
+    DictionaryWord *words = (DictionaryWord *) (image + wordTableOffset);
+    char *strings = image + stringsOffset;
+
+    uint32_t stringPos = 0;
+    for (int i = 0; i < count; i++) {
+        size_t nameLen = strlen(names[i]);
+        categories[i].nameOffset = stringPos;
+        memcpy(strings + stringPos, names[i], nameLen + 1);
+        stringPos += (uint32_t) nameLen + 1;
+    }
+
+    memcpy(strings + stringPos, builder.text, builder.textSize);
+
+    for (uint32_t i = 0; i < builder.wordCount; i++) {
+        const PendingWord *pending = &builder.words[i];
+        DictionaryCategory *category = &categories[pending->category];
+        if (category->wordCount == 0) category->firstWord = i;
+        category->wordCount++;
+        if (pending->length > category->maxLength) category->maxLength = pending->length;
+
+        int distinct, letters;
+        words[i].stringOffset = stringPos + pending->textOffset;
+        words[i].letterMask = dictionaryLetterMask(builder.text + pending->textOffset, &distinct, &letters);
+        words[i].length = (uint8_t) pending->length;
+        words[i].distinctLetters = (uint8_t) distinct;
+        words[i].letterCount = (uint8_t) letters;
+    }
+
+    free(builder.text);
+    free(builder.words);
+
+    //files derived from the dictionary compare this instead of reading every page of it
+    header->contentHash = assetPackHash(image + categoryTableOffset, fileSize - categoryTableOffset);
+
+    dict->image = image;
+    return dictionaryBind(dict, image, fileSize);
+}
+
+/**
+ * Writes a dictionary image to disk so it can be mapped with dictionaryOpen() later
+ *
+ * @param dict a loaded dictionary
+ * @param path output file
+ * @return true if the whole image was written
+ */
+bool dictionaryWrite(const Dictionary *dict, const char *path) {
+    if (!dict->header) return false;
+
+    char tempPath[1024];
+    FILE *file = mappedFileCreate(path, tempPath, sizeof(tempPath));
+    if (!file) return false;
+
+    size_t written = fwrite(dict->header, 1, dict->header->fileSize, file);
+    return mappedFileCommit(file, tempPath, path, written == dict->header->fileSize);
+}
+
+/**
+ * Releases the mapping or in memory image, every pointer handed out becomes invalid
+ *
+ * @param dict Dictionary struct to release, safe to call on a zeroed struct
+ */
+void dictionaryClose(Dictionary *dict) {
+    mappedFileClose(&dict->file);
+    free(dict->image);
+    memset(dict, 0, sizeof(*dict));
+}
+
+int dictionaryCategoryCount(const Dictionary *dict) {
+    return dict->header ? (int) dict->header->categoryCount : 0;
+}
+
+const char *dictionaryCategoryName(const Dictionary *dict, int category) {
+    if (category < 0 || category >= dictionaryCategoryCount(dict)) return NULL;
+    return dict->strings + dict->categories[category].nameOffset;
+}
+
+/**
+ * @return index of the category with the given name, or -1 if there is none
+ */
+int dictionaryFindCategory(const Dictionary *dict, const char *name) {
+    for (int i = 0; i < dictionaryCategoryCount(dict); i++) {
+        if (strcmp(dictionaryCategoryName(dict, i), name) == 0) return i;
+    }
+    return -1;
+}
+
+const DictionaryWord *dictionaryWordInfo(const Dictionary *dict, uint32_t index) {
+    if (!dict->header || index >= dict->header->wordCount) return NULL;
+    return &dict->words[index];
+}
+
+const char *dictionaryWordString(const Dictionary *dict, uint32_t index) {
+    const DictionaryWord *word = dictionaryWordInfo(dict, index);
+    if (!word || word->stringOffset >= dict->header->stringsSize) return NULL;
+    return dict->strings + word->stringOffset;
+}
+
+/**
+ * @return index of the category that owns the word, or -1 if the index is out of range
+ */
+int dictionaryWordCategory(const Dictionary *dict, uint32_t index) {
+    if (!dict->header || index >= dict->header->wordCount) return -1;
+
+    //categories are stored in word order, so the owner is the last one starting at or before index
+    int lo = 0, hi = dictionaryCategoryCount(dict) - 1, found = -1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (dict->categories[mid].firstWord <= index) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    //empty categories share firstWord with the next one, step back to the one that actually holds the word
+    while (found > 0 && index >= dict->categories[found].firstWord + dict->categories[found].wordCount) found--;
+    return found;
+}
+
+/**
+ * Finds the words of one length inside a category, they are contiguous because words are sorted by length
+ *
+ * @param dict a loaded dictionary
+ * @param category index of the category
+ * @param length word length in bytes
+ * @param first receives the global index of the first matching word
+ * @param count receives the number of matching words
+ * @return true if at least one word has that length
+ */
+bool dictionaryLengthRange(const Dictionary *dict, int category, int length, uint32_t *first, uint32_t *count) {
+    *first = 0;
+    *count = 0;
+    if (category < 0 || category >= dictionaryCategoryCount(dict)) return false;
+
+    const DictionaryCategory *cat = &dict->categories[category];
+    uint32_t lo = cat->firstWord;
+    uint32_t hi = cat->firstWord + cat->wordCount;
+
+    //lower bound of length
+    uint32_t a = lo, b = hi;
+    while (a < b) {
+        uint32_t mid = a + (b - a) / 2;
+        if (dict->words[mid].length < length) a = mid + 1;
+        else b = mid;
+    }
+    uint32_t start = a;
+
+    //upper bound of length
+    b = hi;
+    while (a < b) {
+        uint32_t mid = a + (b - a) / 2;
+        if (dict->words[mid].length <= length) a = mid + 1;
+        else b = mid;
+    }
+
+    *first = start;
+    *count = a - start;
+    return *count > 0;
+}
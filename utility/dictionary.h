@@ -0,0 +1,88 @@
+#ifndef HANGMAN_DICTIONARY_H
+#define HANGMAN_DICTIONARY_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mapped_file.h"
+
+// ============================================================================
+// BINARY FORMAT (little endian, every offset is from the start of the file)
+//
+//   DictionaryHeader
+//   DictionaryCategory[categoryCount]
+//   DictionaryWord[wordCount]      words of a category are contiguous and sorted by length
+//   char strings[stringsSize]      null terminated lowercase words and category names
+// ============================================================================
+
+#define DICTIONARY_MAGIC "HNGDICT"
+#define DICTIONARY_VERSION 2
+#define DICTIONARY_DEFAULT_PATH "resources/words/words.dict"
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t categoryCount;
+    uint32_t wordCount;
+    uint32_t categoryTableOffset;
+    uint32_t wordTableOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+    uint32_t fileSize;
+    uint64_t contentHash; //FNV-1a of everything after the header, computed once when the words are packed
+} DictionaryHeader;
+
+typedef struct {
+    uint32_t nameOffset;
+    uint32_t firstWord;
+    uint32_t wordCount;
+    uint32_t maxLength;
+} DictionaryCategory;
+
+//precomputed per word so solvers and filters never have to scan the string
+typedef struct {
+    uint32_t stringOffset;
+    uint32_t letterMask;     //bit i is set when 'a' + i appears in the word
+    uint8_t length;          //length in bytes, spaces included
+    uint8_t distinctLetters; //number of bits set in letterMask
+    uint8_t letterCount;     //number of a-z characters, these are the blanks the player has to fill
+    uint8_t reserved;
+} DictionaryWord;
+
+typedef struct {
+    const DictionaryHeader *header;
+    const DictionaryCategory *categories;
+    const DictionaryWord *words;
+    const char *strings;
+
+    MappedFile file; //empty when built from text or opened from memory
+    void *image; //owned copy when built from text instead of mapped
+} Dictionary;
+
+bool dictionaryOpen(Dictionary *dict, const char *path);
+
+bool dictionaryOpenMemory(Dictionary *dict, const void *data, size_t size);
+
+bool dictionaryBuildFromText(Dictionary *dict, const char *const *names, const char *const *paths, int count);
+
+bool dictionaryWrite(const Dictionary *dict, const char *path);
+
+void dictionaryClose(Dictionary *dict);
+
+int dictionaryCategoryCount(const Dictionary *dict);
+
+const char *dictionaryCategoryName(const Dictionary *dict, int category);
+
+int dictionaryFindCategory(const Dictionary *dict, const char *name);
+
+const DictionaryWord *dictionaryWordInfo(const Dictionary *dict, uint32_t index);
+
+const char *dictionaryWordString(const Dictionary *dict, uint32_t index);
+
+int dictionaryWordCategory(const Dictionary *dict, uint32_t index);
+
+bool dictionaryLengthRange(const Dictionary *dict, int category, int length, uint32_t *first, uint32_t *count);
+
+uint32_t dictionaryLetterMask(const char *word, int *distinctLetters, int *letterCount);
+
+#endif
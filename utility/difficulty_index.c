@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include "difficulty_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const float *sortScores;
+
+static int compareByScore(const void *a, const void *b) {
+    uint32_t wa = *(const uint32_t *) a;
+    uint32_t wb = *(const uint32_t *) b;
+    if (sortScores[wa] != sortScores[wb]) return sortScores[wa] < sortScores[wb] ? -1 : 1;
+    return wa < wb ? -1 : (wa > wb);
+}
+
+/**
+ * Writes the difficulty sidecar for a dictionary, words of each category are ranked by score
+ * and split into equally sized easy, medium and hard bands
+ *
+ * @param path output file
+ * @param dict dictionary the scores were computed for
+ * @param scores one score per global word index, higher is harder
+ * @return true if the file was written
+ */
+bool difficultyIndexWrite(const char *path, const Dictionary *dict, const float *scores) {
+    uint32_t wordCount = dict->header->wordCount;
+    uint32_t categoryCount = dict->header->categoryCount;
+
+    uint32_t scoresOffset = sizeof(DifficultyHeader);
+    uint32_t orderOffset = scoresOffset + wordCount * (uint32_t) sizeof(float);
+    uint32_t bandsOffset = orderOffset + wordCount * (uint32_t) sizeof(uint32_t);
+    uint32_t fileSize = bandsOffset + categoryCount * (DIFFICULTY_BAND_COUNT + 1) * (uint32_t) sizeof(uint32_t);
+
+    char *image = calloc(1, fileSize);
+    if (!image) return false;
+
+    DifficultyHeader *header = (DifficultyHeader *) image;
+    memcpy(header->magic, DIFFICULTY_MAGIC, sizeof(header->magic));
+    header->version = DIFFICULTY_VERSION;
+    header->wordCount = wordCount;
+    header->categoryCount = categoryCount;
+    header->dictionarySize = dict->header->fileSize;
+    header->scoresOffset = scoresOffset;
+    header->orderOffset = orderOffset;
+    header->bandsOffset = bandsOffset;
+    header->fileSize = fileSize;
+    header->dictionaryHash = dict->header->contentHash;
+
+    memcpy(image + scoresOffset, scores, wordCount * sizeof(float));
+
+    uint32_t *order = (uint32_t *) (image + orderOffset);
+    uint32_t *bandStart = (uint32_t *) (image + bandsOffset);
+    for (uint32_t i = 0; i < wordCount; i++) order[i] = i;
+
+    //categories own contiguous word ranges, so each one is ranked in place
+    sortScores = scores;
+    for (uint32_t c = 0; c < categoryCount; c++) {
+        uint32_t first = dict->categories[c].firstWord;
+        uint32_t count = dict->categories[c].wordCount;
+        if (count > 1) qsort(order + first, count, sizeof(uint32_t), compareByScore);
+
+        for (int b = 0; b <= DIFFICULTY_BAND_COUNT; b++) {
+            bandStart[c * (DIFFICULTY_BAND_COUNT + 1) + b] = first + (uint32_t) ((uint64_t) count * b / DIFFICULTY_BAND_COUNT);
+        }
+    }
+    sortScores = NULL;
+
+    char tempPath[1024];
+    FILE *file = mappedFileCreate(path, tempPath, sizeof(tempPath));
+    bool ok = file && mappedFileCommit(file, tempPath, path, fwrite(image, 1, fileSize, file) == fileSize);
+
+    free(image);
+    return ok;
+}
+
+//every band has to stay inside its category and every ranked word has to belong to it,
+//so a corrupt sidecar can never hand out a word index outside the dictionary
+static bool checkTables(const DifficultyHeader *header, const Dictionary *dict) {
+    const uint32_t *order = (const uint32_t *) ((const char *) header + header->orderOffset);
+    const uint32_t *bandStart = (const uint32_t *) ((const char *) header + header->bandsOffset);
+
+    for (uint32_t c = 0; c < header->categoryCount; c++) {
+        uint32_t first = dict->categories[c].firstWord;
+        uint32_t end = first + dict->categories[c].wordCount;
+        const uint32_t *bands = bandStart + c * (DIFFICULTY_BAND_COUNT + 1);
+
+        for (int b = 0; b <= DIFFICULTY_BAND_COUNT; b++) {
+            if (bands[b] < first || bands[b] > end) return false;
+            if (b > 0 && bands[b] < bands[b - 1]) return false;
+        }
+        for (uint32_t i = first; i < end; i++) {
+            if (order[i] < first || order[i] >= end) return false;
+        }
+    }
+    return true;
+}
+
+//checks the sidecar was built for dict and its tables stay inside size bytes
+static bool difficultyIndexBind(DifficultyIndex *index, const void *data, size_t size, const Dictionary *dict) {
+    const DifficultyHeader *header = data;
+    if (size < sizeof(DifficultyHeader)) return false;
+    uint64_t bandsEnd = header->bandsOffset + (uint64_t) header->categoryCount * (DIFFICULTY_BAND_COUNT + 1) * sizeof(uint32_t);
+
+    bool valid = memcmp(header->magic, DIFFICULTY_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == DIFFICULTY_VERSION &&
+                 header->fileSize == size &&
+                 header->wordCount == dict->header->wordCount &&
+                 header->categoryCount == dict->header->categoryCount &&
+                 header->dictionarySize == dict->header->fileSize &&
+                 header->scoresOffset + (uint64_t) header->wordCount * sizeof(float) <= size &&
+                 header->orderOffset + (uint64_t) header->wordCount * sizeof(uint32_t) <= size &&
+                 bandsEnd <= size &&
+                 header->dictionaryHash == dict->header->contentHash &&
+                 header->orderOffset % sizeof(uint32_t) == 0 && header->bandsOffset % sizeof(uint32_t) == 0;
+    if (!valid || !checkTables(header, dict)) return false;
+
+    index->header = header;
+    index->scores = (const float *) ((const char *) header + header->scoresOffset);
+    index->order = (const uint32_t *) ((const char *) header + header->orderOffset);
+    index->bandStart = (const uint32_t *) ((const char *) header + header->bandsOffset);
+    return true;
+}
+
+/**
+ * Maps a difficulty sidecar, it is rejected if it was built for a different dictionary
+ *
+ * @param index DifficultyIndex struct to fill
+ * @param path path of the .difficulty file written by difficulty_indexer
+ * @param dict the loaded dictionary
+ * @return true if the index is valid for dict
+ */
+bool difficultyIndexOpen(DifficultyIndex *index, const char *path, const Dictionary *dict) {
+    memset(index, 0, sizeof(*index));
+    if (!dict->header || !mappedFileOpen(&index->file, path)) return false;
+
+    if (!difficultyIndexBind(index, index->file.data, index->file.size, dict)) {
+        printf("[WARNING] Ignoring difficulty index that does not match the dictionary: %s\n", path);
+        difficultyIndexClose(index);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Same as difficultyIndexOpen(), for a sidecar that is already in memory, such as one inside an asset pack
+ *
+ * @param index DifficultyIndex struct to fill
+ * @param data .difficulty file contents, 4 byte aligned, has to outlive index
+ * @param size bytes of data
+ * @param dict the loaded dictionary
+ * @return true if the index is valid for dict
+ */
+bool difficultyIndexOpenMemory(DifficultyIndex *index, const void *data, size_t size, const Dictionary *dict) {
+    memset(index, 0, sizeof(*index));
+    if (!dict->header) return false;
+
+    if (!difficultyIndexBind(index, data, size, dict)) {
+        printf("[WARNING] Ignoring packed difficulty index that does not match the dictionary\n");
+        return false;
+    }
+    return true;
+}
+
+void difficultyIndexClose(DifficultyIndex *index) {
+    mappedFileClose(&index->file);
+    memset(index, 0, sizeof(*index));
+}
+
+/**
+ * @return difficulty score of a word, higher is harder, 0 if there is no index
+ */
+float difficultyIndexScore(const DifficultyIndex *index, uint32_t wordIndex) {
+    if (!index->header || wordIndex >= index->header->wordCount) return 0.0f;
+    return index->scores[wordIndex];
+}
+
+/**
+ * Picks a random word of one difficulty band in O(1), using the precomputed ranking
+ *
+ * @param index a loaded difficulty index
+ * @param category index of the category
+ * @param band difficulty band to pick from
+ * @param rng random generator to draw from
+ * @param wordIndex receives the global dictionary index of the word
+ * @return false if the band is empty or there is no index
+ */
+bool difficultyIndexRandomWord(const DifficultyIndex *index, int category, DifficultyBand band, Prng *rng,
+                               uint32_t *wordIndex) {
+    if (!index->header || category < 0 || (uint32_t) category >= index->header->categoryCount) return false;
+    if (band < 0 || band >= DIFFICULTY_BAND_COUNT) return false;
+
+    const uint32_t *bands = index->bandStart + category * (DIFFICULTY_BAND_COUNT + 1);
+    uint32_t count = bands[band + 1] - bands[band];
+    if (count == 0) return false;
+
+    *wordIndex = index->order[bands[band] + prngBounded(rng, count)];
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef HANGMAN_DIFFICULTY_INDEX_H
+#define HANGMAN_DIFFICULTY_INDEX_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dictionary.h"
+#include "mapped_file.h"
+#include "prng.h"
+
+// ============================================================================
+// SIDECAR FORMAT (little endian, every offset is from the start of the file)
+//
+//   DifficultyHeader
+//   float scores[wordCount]          difficulty per global dictionary word index
+//   uint32_t order[wordCount]        word indexes, per category sorted from easiest to hardest
+//   uint32_t bandStart[categoryCount][DIFFICULTY_BAND_COUNT + 1]   positions inside order
+// ============================================================================
+
+#define DIFFICULTY_MAGIC "HNGDIFF"
+#define DIFFICULTY_VERSION 3
+#define DIFFICULTY_DEFAULT_PATH "resources/words/words.difficulty"
+
+typedef enum {
+    DIFFICULTY_EASY = 0,
+    DIFFICULTY_MEDIUM,
+    DIFFICULTY_HARD,
+    DIFFICULTY_BAND_COUNT
+} DifficultyBand;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t wordCount;
+    uint32_t categoryCount;
+    uint32_t dictionarySize; //fileSize of the dictionary the scores belong to
+    uint32_t scoresOffset;
+    uint32_t orderOffset;
+    uint32_t bandsOffset;
+    uint32_t fileSize;
+    uint64_t dictionaryHash; //contentHash of that dictionary, a word swapped for one of the same length changes it
+} DifficultyHeader;
+
+typedef struct {
+    const DifficultyHeader *header;
+    const float *scores;
+    const uint32_t *order;
+    const uint32_t *bandStart;
+    MappedFile file;
+} DifficultyIndex;
+
+bool difficultyIndexWrite(const char *path, const Dictionary *dict, const float *scores);
+
+bool difficultyIndexOpen(DifficultyIndex *index, const char *path, const Dictionary *dict);
+
+bool difficultyIndexOpenMemory(DifficultyIndex *index, const void *data, size_t size, const Dictionary *dict);
+
+void difficultyIndexClose(DifficultyIndex *index);
+
+float difficultyIndexScore(const DifficultyIndex *index, uint32_t wordIndex);
+
+bool difficultyIndexRandomWord(const DifficultyIndex *index, int category, DifficultyBand band, Prng *rng,
+                               uint32_t *wordIndex);
+
+#endif
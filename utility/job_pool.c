@@ -0,0 +1,244 @@
+#include "job_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    JobPool *pool;
+    int index;
+} WorkerStart;
+
+static bool queueInit(JobQueue *queue) {
+    memset(queue, 0, sizeof(*queue));
+    queue->capacity = 16;
+    queue->jobs = malloc(queue->capacity * sizeof(Job));
+    if (!queue->jobs) return false;
+    if (!mutexInit(&queue->lock)) {
+        free(queue->jobs);
+        return false;
+    }
+    return true;
+}
+
+static void queueDestroy(JobQueue *queue) {
+    mutexDestroy(&queue->lock);
+    free(queue->jobs);
+    memset(queue, 0, sizeof(*queue));
+}
+
+static bool queuePush(JobQueue *queue, Job job) {
+    mutexLock(&queue->lock);
+    if (queue->count == queue->capacity) {
+        //unroll the ring into a buffer twice the size
+        Job *jobs = malloc(queue->capacity * 2 * sizeof(Job));
+        if (!jobs) {
+            mutexUnlock(&queue->lock);
+            return false;
+        }
+        for (int i = 0; i < queue->count; i++) {
+            jobs[i] = queue->jobs[(queue->head + i) & (queue->capacity - 1)];
+        }
+        free(queue->jobs);
+        queue->jobs = jobs;
+        queue->head = 0;
+        queue->capacity *= 2;
+    }
+    queue->jobs[(queue->head + queue->count) & (queue->capacity - 1)] = job;
+    queue->count++;
+    mutexUnlock(&queue->lock);
+    return true;
+}
+
+//the owner takes the newest job, its data is the most likely to still be in cache
+static bool queuePopNewest(JobQueue *queue, Job *job) {
+    mutexLock(&queue->lock);
+    bool found = queue->count > 0;
+    if (found) {
+        queue->count--;
+        *job = queue->jobs[(queue->head + queue->count) & (queue->capacity - 1)];
+    }
+    mutexUnlock(&queue->lock);
+    return found;
+}
+
+//thieves take the oldest job, so they rarely contend with the owner working at the other end
+static bool queueStealOldest(JobQueue *queue, Job *job) {
+    mutexLock(&queue->lock);
+    bool found = queue->count > 0;
+    if (found) {
+        *job = queue->jobs[queue->head];
+        queue->head = (queue->head + 1) & (queue->capacity - 1);
+        queue->count--;
+    }
+    mutexUnlock(&queue->lock);
+    return found;
+}
+
+static bool takeJob(JobPool *pool, int self, Job *job) {
+    if (queuePopNewest(&pool->queues[self], job)) return true;
+    for (int i = 1; i < pool->threadCount; i++) {
+        if (queueStealOldest(&pool->queues[(self + i) % pool->threadCount], job)) return true;
+    }
+    return false;
+}
+
+static int workerThread(void *data) {
+    WorkerStart start = *(WorkerStart *) data;
+    free(data);
+    JobPool *pool = start.pool;
+
+    for (;;) {
+        Job job;
+        if (takeJob(pool, start.index, &job)) {
+            atomic_fetch_sub(&pool->queued, 1);
+            job.function(job.data);
+
+            if (atomic_fetch_sub(&pool->pending, 1) == 1) {
+                mutexLock(&pool->idleLock);
+                condBroadcast(&pool->done);
+                mutexUnlock(&pool->idleLock);
+            }
+            continue;
+        }
+
+        //queued is raised before a job is pushed, so a positive count with nothing found means a push is in flight
+        mutexLock(&pool->idleLock);
+        while (atomic_load(&pool->queued) == 0 && !atomic_load(&pool->stopping)) {
+            condWait(&pool->wake, &pool->idleLock);
+        }
+        bool stop = atomic_load(&pool->stopping) && atomic_load(&pool->queued) == 0;
+        mutexUnlock(&pool->idleLock);
+        if (stop) return 0;
+    }
+}
+
+/**
+ * Starts the worker threads, they sleep until a job is submitted
+ *
+ * @param pool JobPool struct to initialise
+ * @param threadCount number of workers, 0 or less uses one per logical processor
+ * @return true if every worker started
+ */
+bool jobPoolCreate(JobPool *pool, int threadCount) {
+    memset(pool, 0, sizeof(*pool));
+    if (threadCount <= 0) threadCount = threadCpuCount();
+
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->pending, 0);
+    atomic_init(&pool->nextQueue, 0);
+    atomic_init(&pool->stopping, false);
+
+    pool->queues = calloc(threadCount, sizeof(JobQueue));
+    pool->threads = calloc(threadCount, sizeof(Thread));
+    if (!pool->queues || !pool->threads || !mutexInit(&pool->idleLock)) {
+        free(pool->queues);
+        free(pool->threads);
+        return false;
+    }
+    condInit(&pool->wake);
+    condInit(&pool->done);
+
+    //every queue exists before the first worker starts stealing from them
+    int queues = 0;
+    while (queues < threadCount && queueInit(&pool->queues[queues])) queues++;
+    pool->threadCount = threadCount;
+
+    int started = 0;
+    if (queues == threadCount) {
+        for (; started < threadCount; started++) {
+            WorkerStart *start = malloc(sizeof(WorkerStart));
+            if (!start) break;
+            start->pool = pool;
+            start->index = started;
+            if (!threadCreate(&pool->threads[started], workerThread, start)) {
+                free(start);
+                break;
+            }
+        }
+    }
+
+    if (started != threadCount) {
+        printf("[ERROR] Started %d of %d job pool workers\n", started, threadCount);
+        mutexLock(&pool->idleLock);
+        atomic_store(&pool->stopping, true);
+        condBroadcast(&pool->wake);
+        mutexUnlock(&pool->idleLock);
+        for (int i = 0; i < started; i++) threadJoin(&pool->threads[i]);
+        for (int i = 0; i < queues; i++) queueDestroy(&pool->queues[i]);
+
+        condDestroy(&pool->wake);
+        condDestroy(&pool->done);
+        mutexDestroy(&pool->idleLock);
+        free(pool->queues);
+        free(pool->threads);
+        memset(pool, 0, sizeof(*pool));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Queues function(data) to run on one of the workers
+ *
+ * @param pool pool started with jobPoolCreate()
+ * @param function job to run, it may submit more jobs
+ * @param data pointer passed to function
+ * @return false if the job could not be queued
+ */
+bool jobPoolSubmit(JobPool *pool, JobFunction function, void *data) {
+    Job job = {function, data};
+    unsigned int queue = atomic_fetch_add(&pool->nextQueue, 1) % (unsigned int) pool->threadCount;
+
+    atomic_fetch_add(&pool->pending, 1);
+    atomic_fetch_add(&pool->queued, 1);
+    if (!queuePush(&pool->queues[queue], job)) {
+        atomic_fetch_sub(&pool->queued, 1);
+        atomic_fetch_sub(&pool->pending, 1);
+        return false;
+    }
+
+    mutexLock(&pool->idleLock);
+    condSignal(&pool->wake);
+    mutexUnlock(&pool->idleLock);
+    return true;
+}
+
+/**
+ * Blocks until every submitted job has finished, including jobs submitted by jobs
+ *
+ * @param pool pool started with jobPoolCreate()
+ */
+void jobPoolWait(JobPool *pool) {
+    mutexLock(&pool->idleLock);
+    while (atomic_load(&pool->pending) > 0) {
+        condWait(&pool->done, &pool->idleLock);
+    }
+    mutexUnlock(&pool->idleLock);
+}
+
+/**
+ * Runs the jobs still queued, then stops and joins every worker
+ *
+ * @param pool pool started with jobPoolCreate()
+ */
+void jobPoolDestroy(JobPool *pool) {
+    mutexLock(&pool->idleLock);
+    atomic_store(&pool->stopping, true);
+    condBroadcast(&pool->wake);
+    mutexUnlock(&pool->idleLock);
+
+    for (int i = 0; i < pool->threadCount; i++) {
+        threadJoin(&pool->threads[i]);
+    }
+    for (int i = 0; i < pool->threadCount; i++) {
+        queueDestroy(&pool->queues[i]);
+    }
+
+    condDestroy(&pool->wake);
+    condDestroy(&pool->done);
+    mutexDestroy(&pool->idleLock);
+    free(pool->queues);
+    free(pool->threads);
+    memset(pool, 0, sizeof(*pool));
+}
@@ -0,0 +1,48 @@
+#ifndef HANGMAN_JOB_POOL_H
+#define HANGMAN_JOB_POOL_H
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "threads.h"
+
+typedef void (*JobFunction)(void *data);
+
+typedef struct {
+    JobFunction function;
+    void *data;
+} Job;
+
+//ring of jobs owned by one worker, the owner works newest first and thieves take the oldest
+typedef struct {
+    Mutex lock;
+    Job *jobs;
+    int head;     //oldest job
+    int count;
+    int capacity; //power of two
+} JobQueue;
+
+//fixed set of worker threads, each with its own queue, an idle worker steals from the others
+typedef struct {
+    JobQueue *queues;
+    Thread *threads;
+    int threadCount;
+
+    atomic_int queued;  //jobs sitting in a queue
+    atomic_int pending; //jobs submitted and not finished yet
+    atomic_uint nextQueue;
+    atomic_bool stopping;
+
+    Mutex idleLock;
+    Cond wake; //signalled when a job is queued or the pool stops
+    Cond done; //broadcast when pending drops to 0
+} JobPool;
+
+bool jobPoolCreate(JobPool *pool, int threadCount);
+
+bool jobPoolSubmit(JobPool *pool, JobFunction function, void *data);
+
+void jobPoolWait(JobPool *pool);
+
+void jobPoolDestroy(JobPool *pool);
+
+#endif
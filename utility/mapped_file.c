@@ -0,0 +1,135 @@
+#include "mapped_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Maps a file read only into memory, nothing is read from disk until a page is touched
+ *
+ * @param file MappedFile struct that receives the view
+ * @param path path of the file to map
+ * @return true if the file was mapped, empty files are rejected
+ */
+bool mappedFileOpen(MappedFile *file, const char *path) {
+    memset(file, 0, sizeof(*file));
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+
+    file->data = data;
+    file->size = (size_t) size.QuadPart;
+    file->fileHandle = handle;
+    file->mappingHandle = mapping;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    //the mapping keeps its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    file->data = data;
+    file->size = (size_t) st.st_size;
+#endif
+
+    return true;
+}
+
+/**
+ * Unmaps a file opened with mappedFileOpen(), every pointer into it becomes invalid
+ *
+ * @param file MappedFile struct to release, safe to call on a zeroed struct
+ */
+void mappedFileClose(MappedFile *file) {
+    if (!file->data) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(file->data);
+    CloseHandle(file->mappingHandle);
+    CloseHandle(file->fileHandle);
+#else
+    munmap((void *) file->data, file->size);
+#endif
+
+    memset(file, 0, sizeof(*file));
+}
+
+/**
+ * Opens a temporary file next to path for writing, named after the process so concurrent writers do not share it
+ *
+ * @param path file that will be replaced by mappedFileCommit()
+ * @param tempPath receives the temporary name
+ * @param tempPathSize bytes of tempPath
+ * @return the open file, or NULL if it could not be created
+ */
+FILE *mappedFileCreate(const char *path, char *tempPath, size_t tempPathSize) {
+#ifdef _WIN32
+    unsigned long pid = (unsigned long) GetCurrentProcessId();
+#else
+    unsigned long pid = (unsigned long) getpid();
+#endif
+    int length = snprintf(tempPath, tempPathSize, "%s.%lu.tmp", path, pid);
+    if (length < 0 || (size_t) length >= tempPathSize) return NULL;
+
+    FILE *file = fopen(tempPath, "wb");
+    if (!file) perror("Failed to open file");
+    return file;
+}
+
+/**
+ * Closes a file from mappedFileCreate() and moves it over path, or deletes it when writing failed
+ *
+ * @param file the open temporary file
+ * @param tempPath name mappedFileCreate() returned
+ * @param path file to replace
+ * @param ok false when anything was not written, path is then left as it was
+ * @return true if path now holds the complete file
+ */
+bool mappedFileCommit(FILE *file, const char *tempPath, const char *path, bool ok) {
+    if (fclose(file) != 0) ok = false;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING);
+#else
+    ok = ok && rename(tempPath, path) == 0;
+#endif
+    if (!ok) remove(tempPath);
+    return ok;
+}
@@ -0,0 +1,27 @@
+#ifndef HANGMAN_MAPPED_FILE_H
+#define HANGMAN_MAPPED_FILE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+//read only view of a whole file, pages are faulted in on first access
+typedef struct {
+    const void *data;
+    size_t size;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+} MappedFile;
+
+bool mappedFileOpen(MappedFile *file, const char *path);
+
+void mappedFileClose(MappedFile *file);
+
+//files meant to be mapped are written under a temporary name and renamed over path once complete,
+//so a reader never maps a half written file and two writers of the same path never interleave
+FILE *mappedFileCreate(const char *path, char *tempPath, size_t tempPathSize);
+
+bool mappedFileCommit(FILE *file, const char *tempPath, const char *path, bool ok);
+
+#endif
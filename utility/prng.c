@@ -0,0 +1,132 @@
+#include "prng.h"
+
+#include <stdatomic.h>
+#include <time.h>
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * splitmix64 step, used to expand a single seed into the full generator state
+ * Also usable on its own when 8 bytes of state is all that fits
+ *
+ * @param state 64 bit generator state, advanced by the call
+ * @return next 64 random bits
+ */
+uint64_t prngSplitMix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Seeds the generator, the same seed always produces the same sequence
+ *
+ * @param rng generator state to initialise
+ * @param seed any 64 bit value, 0 included
+ */
+void prngSeed(Prng *rng, uint64_t seed) {
+    uint64_t state = seed;
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = prngSplitMix64(&state);
+    }
+}
+
+/**
+ * @param rng generator state
+ * @return next 64 random bits
+ */
+uint64_t prngNext(Prng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+/**
+ * Returns a uniformly distributed number in [0, bound) without modulo bias (Lemire's method)
+ *
+ * @param rng generator state
+ * @param bound exclusive upper limit, 0 returns 0
+ * @return random number below bound
+ */
+uint32_t prngBounded(Prng *rng, uint32_t bound) {
+    if (bound == 0) return 0;
+
+    uint64_t m = (uint64_t) (uint32_t) (prngNext(rng) >> 32) * bound;
+    uint32_t low = (uint32_t) m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = (uint64_t) (uint32_t) (prngNext(rng) >> 32) * bound;
+            low = (uint32_t) m;
+        }
+    }
+    return (uint32_t) (m >> 32);
+}
+
+/**
+ * @param rng generator state
+ * @return uniformly distributed number in [0, 1)
+ */
+double prngDouble(Prng *rng) {
+    return (prngNext(rng) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * Advances the generator by 2^128 steps, jumping a copy of one seeded state gives
+ * non overlapping streams for worker threads
+ *
+ * @param rng generator state
+ */
+void prngJump(Prng *rng) {
+    static const uint64_t jump[] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & (1ULL << b)) {
+                s0 ^= rng->s[0];
+                s1 ^= rng->s[1];
+                s2 ^= rng->s[2];
+                s3 ^= rng->s[3];
+            }
+            prngNext(rng);
+        }
+    }
+
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+}
+
+/**
+ * Builds a seed that differs between runs and between calls within the same second
+ *
+ * @return seed for prngSeed()
+ */
+uint64_t prngEntropySeed(void) {
+    static atomic_uint_fast64_t counter;
+
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    uint64_t state = (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+    state ^= (uint64_t) (uintptr_t) &ts;
+    state ^= (uint64_t) clock() << 32;
+    state += atomic_fetch_add(&counter, 1) * 0xD1B54A32D192ED03ULL;
+    return prngSplitMix64(&state);
+}
@@ -0,0 +1,24 @@
+#ifndef HANGMAN_PRNG_H
+#define HANGMAN_PRNG_H
+#include <stdint.h>
+
+//xoshiro256** generator, every session owns one so nothing is shared between threads
+typedef struct {
+    uint64_t s[4];
+} Prng;
+
+void prngSeed(Prng *rng, uint64_t seed);
+
+uint64_t prngNext(Prng *rng);
+
+uint32_t prngBounded(Prng *rng, uint32_t bound);
+
+double prngDouble(Prng *rng);
+
+void prngJump(Prng *rng);
+
+uint64_t prngEntropySeed(void);
+
+uint64_t prngSplitMix64(uint64_t *state);
+
+#endif
@@ -0,0 +1,179 @@
+#include "threads.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+typedef struct {
+    ThreadFunction function;
+    void *data;
+} ThreadStart;
+
+#ifdef _WIN32
+static DWORD WINAPI threadEntry(LPVOID param) {
+    ThreadStart start = *(ThreadStart *) param;
+    free(param);
+    return (DWORD) start.function(start.data);
+}
+#else
+static void *threadEntry(void *param) {
+    ThreadStart start = *(ThreadStart *) param;
+    free(param);
+    return (void *) (intptr_t) start.function(start.data);
+}
+#endif
+
+/**
+ * Starts a thread running function(data)
+ *
+ * @param thread Thread struct that receives the handle
+ * @param function function to run, its return value is handed back by threadJoin()
+ * @param data pointer passed to function
+ * @return true if the thread was started
+ */
+bool threadCreate(Thread *thread, ThreadFunction function, void *data) {
+    ThreadStart *start = malloc(sizeof(ThreadStart));
+    if (!start) return false;
+    start->function = function;
+    start->data = data;
+
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, threadEntry, start, 0, NULL);
+    if (!thread->handle) {
+        free(start);
+        return false;
+    }
+#else
+    if (pthread_create(&thread->handle, NULL, threadEntry, start) != 0) {
+        free(start);
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * Waits for a thread to finish
+ *
+ * @param thread thread started with threadCreate()
+ * @return value returned by the thread function
+ */
+int threadJoin(Thread *thread) {
+#ifdef _WIN32
+    DWORD result = 0;
+    WaitForSingleObject(thread->handle, INFINITE);
+    GetExitCodeThread(thread->handle, &result);
+    CloseHandle(thread->handle);
+    return (int) result;
+#else
+    void *result = NULL;
+    pthread_join(thread->handle, &result);
+    return (int) (intptr_t) result;
+#endif
+}
+
+/**
+ * @return number of logical processors, at least 1
+ */
+int threadCpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+#endif
+}
+
+/**
+ * @param mutex Mutex struct to initialise, it is not recursive
+ * @return true if the mutex is ready
+ */
+bool mutexInit(Mutex *mutex) {
+#ifdef _WIN32
+    InitializeCriticalSection(&mutex->handle);
+    return true;
+#else
+    return pthread_mutex_init(&mutex->handle, NULL) == 0;
+#endif
+}
+
+void mutexLock(Mutex *mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_lock(&mutex->handle);
+#endif
+}
+
+void mutexUnlock(Mutex *mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_unlock(&mutex->handle);
+#endif
+}
+
+void mutexDestroy(Mutex *mutex) {
+#ifdef _WIN32
+    DeleteCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_destroy(&mutex->handle);
+#endif
+}
+
+/**
+ * @param cond Cond struct to initialise
+ * @return true if the condition variable is ready
+ */
+bool condInit(Cond *cond) {
+#ifdef _WIN32
+    InitializeConditionVariable(&cond->handle);
+    return true;
+#else
+    return pthread_cond_init(&cond->handle, NULL) == 0;
+#endif
+}
+
+/**
+ * Releases mutex while waiting and takes it again before returning, wakeups can be spurious
+ *
+ * @param cond condition to wait for
+ * @param mutex locked mutex that guards the condition
+ */
+void condWait(Cond *cond, Mutex *mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(&cond->handle, &mutex->handle, INFINITE);
+#else
+    pthread_cond_wait(&cond->handle, &mutex->handle);
+#endif
+}
+
+void condSignal(Cond *cond) {
+#ifdef _WIN32
+    WakeConditionVariable(&cond->handle);
+#else
+    pthread_cond_signal(&cond->handle);
+#endif
+}
+
+void condBroadcast(Cond *cond) {
+#ifdef _WIN32
+    WakeAllConditionVariable(&cond->handle);
+#else
+    pthread_cond_broadcast(&cond->handle);
+#endif
+}
+
+void condDestroy(Cond *cond) {
+#ifdef _WIN32
+    (void) cond;
+#else
+    pthread_cond_destroy(&cond->handle);
+#endif
+}
@@ -0,0 +1,56 @@
+#ifndef HANGMAN_THREADS_H
+#define HANGMAN_THREADS_H
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef struct {
+    void *handle;
+} Thread;
+typedef struct {
+    CRITICAL_SECTION handle;
+} Mutex;
+typedef struct {
+    CONDITION_VARIABLE handle;
+} Cond;
+#else
+#include <pthread.h>
+typedef struct {
+    pthread_t handle;
+} Thread;
+typedef struct {
+    pthread_mutex_t handle;
+} Mutex;
+typedef struct {
+    pthread_cond_t handle;
+} Cond;
+#endif
+
+//thin wrapper so tools that do not link SDL can still use every core
+typedef int (*ThreadFunction)(void *data);
+
+bool threadCreate(Thread *thread, ThreadFunction function, void *data);
+
+int threadJoin(Thread *thread);
+
+int threadCpuCount(void);
+
+bool mutexInit(Mutex *mutex);
+
+void mutexLock(Mutex *mutex);
+
+void mutexUnlock(Mutex *mutex);
+
+void mutexDestroy(Mutex *mutex);
+
+bool condInit(Cond *cond);
+
+void condWait(Cond *cond, Mutex *mutex);
+
+void condSignal(Cond *cond);
+
+void condBroadcast(Cond *cond);
+
+void condDestroy(Cond *cond);
+
+#endif
@@ -1,83 +1,141 @@
 #include <stdio.h>
 #include "utilities.h"
+#include "word_corpus.h"
 
 #include <ctype.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include <stdbool.h>
 
 /**
  * Returns a random word representing the txt files we have in our resources
  *
- * @return random word from the local array words[]
+ * @param rng random generator to draw from
+ * @return name of a random category from the word corpus
  */
-char *getRandomWordFileName() {
-    char *words[] = {
-        "animals",
-        "continents",
-        "countries",
-        "fruits",
-        "planets",
-        "vegetables"
-    };
-
-    int word_count = sizeof(words) / sizeof(words[0]);
-    int random_index = rand() % word_count;
-
-    return words[random_index];
+char *getRandomWordFileName(Prng *rng) {
+    return (char *) wordCorpusCategoryName(wordCorpusRandomCategory(rng));
+}
+
+/**
+ * Reservoir sampling skip step: after the line-th line has been picked, returns which line replaces it next
+ * Drawing the gap directly keeps random calls logarithmic in the number of lines
+ *
+ * @param line number of lines seen so far
+ * @param rng random generator to draw from
+ * @return line number of the next pick
+ */
+static unsigned long nextReservoirPick(unsigned long line, Prng *rng) {
+    //u is uniform in (0, 1], the next pick is the first line m with m > line / u
+    double u = 1.0 - prngDouble(rng);
+    double next = line / u + 1.0;
+    if (next >= (double) ULONG_MAX) return ULONG_MAX;
+    return (unsigned long) next;
 }
 
 /**
  * Returns a random word from the specified text file
  *
  * @param fileName name of txt file that we get random word from
- * @return random word from fileName file
+ * @param rng random generator to draw from
+ * @return random word from fileName file, the caller has to free it
  */
-char *getRandomWordFromFile(const char *fileName) {
+char *getRandomWordFromFile(const char *fileName, Prng *rng) {
     //look for filename txt file inside resources folder
     char path[256];
     snprintf(path, sizeof(path), "resources/words/%s.txt", fileName);
 
-    FILE *file = fopen(path, "r");
+    return getRandomWordFromPath(path, rng);
+}
+
+/**
+ * Returns a random non empty line from a text file of any size
+ * The file is streamed once in large blocks and a line is picked by reservoir sampling,
+ * so memory use does not depend on how many lines the file has
+ *
+ * @param path path of the text file
+ * @param rng random generator to draw from
+ * @return random line from the file, the caller has to free it
+ */
+char *getRandomWordFromPath(const char *path, Prng *rng) {
+    FILE *file = fopen(path, "rb");
     if (file == NULL) {
         perror("Failed to open file");
         return NULL;
     }
 
-    //read all lines into array of strings
-    char *lines[256]; //max 256 lines possible
-    int lineCount = 0;
-    char buffer[256];
+    char *block = malloc(WORD_STREAM_BLOCK_SIZE);
+    if (!block) {
+        fclose(file);
+        return NULL;
+    }
+    char carry[256]; //start of a line that continues in the next block
+    size_t carryLen = 0;
+    char selected[256];
+    size_t selectedLen = 0;
+    unsigned long lineCount = 0;
+    unsigned long nextPick = 1;
+    size_t read;
+    bool eof = false;
+
+    while (!eof) {
+        read = fread(block, 1, WORD_STREAM_BLOCK_SIZE, file);
+        eof = read < WORD_STREAM_BLOCK_SIZE;
+
+        size_t pos = 0;
+        while (pos < read || (eof && carryLen > 0)) {
+            const char *line;
+            size_t lineLen;
+
+            char *newline = pos < read ? memchr(block + pos, '\n', read - pos) : NULL;
+            if (!newline && !eof) {
+                //line continues in the next block, keep what fits
+                size_t take = read - pos;
+                if (take > sizeof(carry) - 1 - carryLen) take = sizeof(carry) - 1 - carryLen;
+                memcpy(carry + carryLen, block + pos, take);
+                carryLen += take;
+                break;
+            }
 
-    while (fgets(buffer, sizeof(buffer), file)) {
-        //remove new line characters
-        buffer[strcspn(buffer, "\n")] = '\0';
+            size_t end = newline ? (size_t) (newline - block) : read;
+            if (carryLen > 0) {
+                size_t take = end - pos;
+                if (take > sizeof(carry) - 1 - carryLen) take = sizeof(carry) - 1 - carryLen;
+                memcpy(carry + carryLen, block + pos, take);
+                line = carry;
+                lineLen = carryLen + take;
+                carryLen = 0;
+            } else {
+                line = block + pos;
+                lineLen = end - pos;
+                if (lineLen > sizeof(selected) - 1) lineLen = sizeof(selected) - 1;
+            }
+            pos = end + 1;
 
-        //store each line
-        lines[lineCount] = malloc(strlen(buffer) + 1);
-        strcpy(lines[lineCount], buffer);
-        lineCount++;
+            //remove carriage return
+            while (lineLen > 0 && line[lineLen - 1] == '\r') lineLen--;
+            if (lineLen == 0) continue;
 
-        if (lineCount >= 256) break; //prevent overflow
+            //the k-th line replaces the current pick with probability 1/k
+            lineCount++;
+            if (lineCount == nextPick) {
+                memcpy(selected, line, lineLen);
+                selectedLen = lineLen;
+                nextPick = nextReservoirPick(lineCount, rng);
+            }
+        }
     }
 
+    free(block);
     fclose(file);
 
     if (lineCount == 0) return NULL; //file would be empty
 
-    //choose random number
-    srand(time(NULL));
-    int random_index = rand() % (lineCount);
-
-    //choose and copy the random line to return
-    char *selectedLine = malloc(strlen(lines[random_index]) + 1);
-    strcpy(selectedLine, lines[random_index]);
-
-    //free all others
-    for (int i = 0; i < lineCount; i++) {
-        free(lines[i]);
-    }
+    char *selectedLine = malloc(selectedLen + 1);
+    if (!selectedLine) return NULL;
+    memcpy(selectedLine, selected, selectedLen);
+    selectedLine[selectedLen] = '\0';
 
     return selectedLine;
 }
@@ -2,9 +2,15 @@
 #define HANGMAN_UTILITIES_H
 #include <stdbool.h>
 
-char *getRandomWordFileName();
+#include "prng.h"
 
-char *getRandomWordFromFile(const char *fileName);
+#define WORD_STREAM_BLOCK_SIZE (256 * 1024)
+
+char *getRandomWordFileName(Prng *rng);
+
+char *getRandomWordFromFile(const char *fileName, Prng *rng);
+
+char *getRandomWordFromPath(const char *path, Prng *rng);
 
 char *stringToLower(char *word);
 
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include "word_corpus.h"
+#include "asset_pack.h"
+
+#define DEFAULT_CATEGORY_COUNT 6
+
+//word lists used when no packed dictionary is present
+static const char *defaultCategoryNames[DEFAULT_CATEGORY_COUNT] = {
+    "animals",
+    "continents",
+    "countries",
+    "fruits",
+    "planets",
+    "vegetables"
+};
+
+//every word of every category lives in one dictionary image, words are found through its offset table
+static struct {
+    Dictionary dict;
+    DifficultyIndex difficulty; //optional, empty when words.difficulty is missing or stale
+    bool loaded;
+} corpus;
+
+/**
+ * Loads every category word list once, call this at startup before picking any words
+ * The packed dictionary is read from the mounted asset pack or mapped if it exists,
+ * otherwise the text lists are parsed into memory
+ *
+ * @return true if a dictionary was loaded
+ */
+bool wordCorpusInit(void) {
+    if (corpus.loaded) return true;
+
+    size_t dictSize, difficultySize;
+    const void *dictData = assetPackGet(DICTIONARY_DEFAULT_PATH, &dictSize);
+    const void *difficultyData = assetPackGet(DIFFICULTY_DEFAULT_PATH, &difficultySize);
+    if (dictData && dictionaryOpenMemory(&corpus.dict, dictData, dictSize)) {
+        if (difficultyData) {
+            difficultyIndexOpenMemory(&corpus.difficulty, difficultyData, difficultySize, &corpus.dict);
+        } else {
+            difficultyIndexOpen(&corpus.difficulty, DIFFICULTY_DEFAULT_PATH, &corpus.dict);
+        }
+        corpus.loaded = true;
+        return true;
+    }
+
+    if (dictionaryOpen(&corpus.dict, DICTIONARY_DEFAULT_PATH)) {
+        difficultyIndexOpen(&corpus.difficulty, DIFFICULTY_DEFAULT_PATH, &corpus.dict);
+        corpus.loaded = true;
+        return true;
+    }
+
+    char pathStorage[DEFAULT_CATEGORY_COUNT][256];
+    const char *paths[DEFAULT_CATEGORY_COUNT];
+    for (int i = 0; i < DEFAULT_CATEGORY_COUNT; i++) {
+        snprintf(pathStorage[i], sizeof(pathStorage[i]), "resources/words/%s.txt", defaultCategoryNames[i]);
+        paths[i] = pathStorage[i];
+    }
+
+    if (!dictionaryBuildFromText(&corpus.dict, defaultCategoryNames, paths, DEFAULT_CATEGORY_COUNT)) return false;
+
+    //the scores are only used if the text lists still match the dictionary they were computed for
+    difficultyIndexOpen(&corpus.difficulty, DIFFICULTY_DEFAULT_PATH, &corpus.dict);
+    corpus.loaded = true;
+    return true;
+}
+
+/**
+ * Releases the dictionary, every pointer handed out by the corpus becomes invalid
+ */
+void wordCorpusDestroy(void) {
+    difficultyIndexClose(&corpus.difficulty);
+    dictionaryClose(&corpus.dict);
+    corpus.loaded = false;
+}
+
+/**
+ * @return the loaded dictionary, for modules that work with word indexes and metadata directly
+ */
+const Dictionary *wordCorpusDictionary(void) {
+    return &corpus.dict;
+}
+
+/**
+ * @return number of word categories
+ */
+int wordCorpusCategoryCount(void) {
+    return dictionaryCategoryCount(&corpus.dict);
+}
+
+/**
+ * Returns the name of a category, this is also the name of its txt file inside resources/words
+ *
+ * @param category index of the category
+ * @return category name, or NULL if the index is out of range
+ */
+const char *wordCorpusCategoryName(int category) {
+    return dictionaryCategoryName(&corpus.dict, category);
+}
+
+/**
+ * @param category index of the category
+ * @return number of words loaded for the category
+ */
+int wordCorpusWordCount(int category) {
+    if (category < 0 || category >= wordCorpusCategoryCount()) return 0;
+    return (int) corpus.dict.categories[category].wordCount;
+}
+
+/**
+ * Returns a view of a lowercase word inside the dictionary, the caller must not modify or free it
+ *
+ * @param category index of the category
+ * @param index index of the word inside the category
+ * @return the word, or NULL if either index is out of range
+ */
+const char *wordCorpusWord(int category, int index) {
+    if (index < 0 || index >= wordCorpusWordCount(category)) return NULL;
+    return dictionaryWordString(&corpus.dict, corpus.dict.categories[category].firstWord + index);
+}
+
+/**
+ * @param rng random generator to draw from
+ * @return index of a random category
+ */
+int wordCorpusRandomCategory(Prng *rng) {
+    return (int) prngBounded(rng, (uint32_t) wordCorpusCategoryCount());
+}
+
+/**
+ * Picks a random word from a category without touching the disk or allocating
+ *
+ * @param category index of the category
+ * @param rng random generator to draw from
+ * @return view of the random word, or NULL if the category has no words
+ */
+const char *wordCorpusRandomWord(int category, Prng *rng) {
+    int count = wordCorpusWordCount(category);
+    if (count == 0) return NULL;
+    return wordCorpusWord(category, (int) prngBounded(rng, (uint32_t) count));
+}
+
+/**
+ * @return true if a difficulty index matching the dictionary was loaded
+ */
+bool wordCorpusHasDifficulty(void) {
+    return corpus.difficulty.header != NULL;
+}
+
+/**
+ * Picks a random word of the given difficulty in O(1), words are ranked offline by difficulty_indexer
+ * Without a difficulty index every band falls back to wordCorpusRandomWord()
+ *
+ * @param category index of the category
+ * @param band difficulty band to pick from
+ * @param rng random generator to draw from
+ * @return view of the random word, or NULL if the category has no words
+ */
+const char *wordCorpusRandomWordInBand(int category, DifficultyBand band, Prng *rng) {
+    uint32_t wordIndex;
+    if (!difficultyIndexRandomWord(&corpus.difficulty, category, band, rng, &wordIndex)) {
+        return wordCorpusRandomWord(category, rng);
+    }
+    return dictionaryWordString(&corpus.dict, wordIndex);
+}
@@ -0,0 +1,31 @@
+#ifndef HANGMAN_WORD_CORPUS_H
+#define HANGMAN_WORD_CORPUS_H
+#include <stdbool.h>
+
+#include "prng.h"
+#include "dictionary.h"
+#include "difficulty_index.h"
+
+bool wordCorpusInit(void);
+
+void wordCorpusDestroy(void);
+
+const Dictionary *wordCorpusDictionary(void);
+
+int wordCorpusCategoryCount(void);
+
+const char *wordCorpusCategoryName(int category);
+
+int wordCorpusWordCount(int category);
+
+const char *wordCorpusWord(int category, int index);
+
+int wordCorpusRandomCategory(Prng *rng);
+
+const char *wordCorpusRandomWord(int category, Prng *rng);
+
+bool wordCorpusHasDifficulty(void);
+
+const char *wordCorpusRandomWordInBand(int category, DifficultyBand band, Prng *rng);
+
+#endif